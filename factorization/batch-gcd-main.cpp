@@ -0,0 +1,36 @@
+#include "BatchGcd.h"
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <file with one number per line>\n";
+        return 1;
+    }
+
+    try {
+        const std::filesystem::path file_path = argv[1];
+        const auto moduli = batch_gcd::read_moduli_from_file(file_path);
+        std::cout << "Read " << moduli.size() << " moduli from " << file_path.string() << "\n";
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        const auto factors = batch_gcd::shared_factors(moduli);
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        std::size_t weak_moduli = 0;
+        for (std::size_t ii = 0; ii < moduli.size(); ii++) {
+            if (factors[ii] != BigUint::ONE) {
+                weak_moduli++;
+                std::cout << moduli[ii] << " shares the factor " << factors[ii] << '\n';
+            }
+        }
+
+        const std::chrono::duration<double, std::milli> duration = end - start;
+        std::cout << weak_moduli << " of " << moduli.size() << " moduli share a factor, found in " << duration.count() << " ms\n";
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
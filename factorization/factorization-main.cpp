@@ -1,195 +1,637 @@
 #include <filesystem>
 
 #include "BigUint.h"
+#include "FactorCache.h"
+#include "FactorJournal.h"
+#include "Factorizer.h"
+#include "FactorTable.h"
+#include "MappedFactorTable.h"
+#include "Primality.h"
+#include "Sieve.h"
+#include "SweepCheckpoint.h"
 #include <iostream>
 #include <fstream>
 #include <exception>
-#include <map>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 std::ostream & print(const BigUint& a, std::ostream &out = std::cout) {
     out << a.to_base10_string() << " <--> " << a.to_string();
     return out;
 }
 
-std::size_t count_number_of_lines(const std::filesystem::path &path) {
-    std::ifstream fin(path, std::ios::binary); // Binary mode for performance
-    if (!fin) {
-        throw std::runtime_error("Could not open file " + path.string());
+// Contiguous word array so trial division is a tight scan
+using PrimeNumbers = std::vector<uint64_t>;
+
+void print_number_and_its_factors(const BigUint &number, const std::vector<BigUint> &factors) {
+    std::cout << number << ' ';
+    if (factors.empty()) {
+        std::cout << " is prime";
+    }
+    else {
+        std::cout << " = " << factors[0];
+        for (std::size_t ii = 1; ii < factors.size(); ii++) {
+            std::cout << " * " << factors[ii];
+        }
     }
+}
 
-    constexpr std::size_t buffer_size = 4'096;
-    char buffer[buffer_size];
-    std::size_t line_counter = 0;
+void summarize_factor_table(const FactorTable &factor_table) {
+    factor_table.for_each([](const BigUint &number, const std::vector<BigUint> &factors) {
+        print_number_and_its_factors(number, factors);
+        std::cout << '\n';
+    });
+}
 
-    while (fin.read(buffer, buffer_size) || fin.gcount() > 0) {
-        std::streamsize bytes_read = fin.gcount();
-        for (std::streamsize ii = 0; ii < bytes_read; ii++) {
-            if (buffer[ii] == '\n') {
-                line_counter++;
-            }
-        }
+void load_primes_from_sieve(const BigUint &limit, PrimeNumbers &prime_numbers) {
+    const auto word_limit = limit.as_native_word();
+    if (!word_limit || *word_limit > UINT32_MAX) {
+        throw std::runtime_error("cannot sieve primes up to " + limit.to_base10_string());
     }
 
-    fin.close();
-    return line_counter;
+    const auto primes = sieve::primes_below(static_cast<uint32_t>(*word_limit), std::thread::hardware_concurrency());
+    prime_numbers.reserve(prime_numbers.size() + primes.size());
+    for (const auto prime : primes) {
+        prime_numbers.push_back(prime);
+    }
 }
 
-using FactorTable = std::map<BigUint, std::vector<BigUint>>;
-using PrimeNumbers = std::vector<BigUint>;
+// One past the dense run of the table, every number of the run is factored. Sparse keys can be far larger
+BigUint dense_end(const FactorTable &factor_table) {
+    return BigUint::from_native_word(factor_table.dense_low() + factor_table.smallest_factors().size());
+}
 
-[[nodiscard]] FactorTable build_factor_table_from_file(const std::filesystem::path &path) {
-    std::ifstream fin(path);
-    if (!fin) {
-        throw std::runtime_error("Could not open file " + path.string());
+// Smallest prime in the table larger than value, binary search over the sorted prime array
+uint64_t next_prime(const PrimeNumbers &prime_numbers, const uint64_t value) {
+    const auto itr = std::ranges::upper_bound(prime_numbers, value);
+    if (itr == prime_numbers.end()) {
+        throw std::runtime_error("Could not get next prime to " + std::to_string(value));
     }
 
-    FactorTable factor_table;
-    std::string line;
-    std::size_t line_counter = 0;
-    while (std::getline(fin, line)) {
-        line_counter++;
-        std::istringstream iss(line);
-        iss >> std::noskipws;
-        if (line.empty()) {
-            std::cerr << "line " << line_counter << " is empty" << std::endl;
-            continue;
-        }
+    return *itr;
+}
 
-        BigUint number;
-        std::vector<BigUint> factors;
-        iss >> number;
-        while (!iss.eof()) {
-            try {
-                BigUint factor;
-                iss >> factor;
-                factors.emplace_back(factor);
-            } catch (const std::exception &e) {
-                throw std::runtime_error("Could not parse line " + std::to_string(line_counter) + ": " + e.what());
-            }
+// The factorization pipeline, consulting the table, in memory or mapped, and then the cache of new results before any work
+template <typename Table>
+factor::Factorizer make_factorizer(const Table &factor_table, const std::size_t threads, const FactorCache *cache = nullptr, factor::EcmProgress progress = {}) {
+    factor::FactorizerOptions options;
+    options.threads = threads;
+    return factor::Factorizer(options, [&factor_table, cache](const BigUint &number) {
+        auto factors = factor_table.find(number);
+        if (!factors && cache != nullptr) {
+            factors = cache->find(number);
         }
+        return factors;
+    }, std::move(progress));
+}
 
-        factor_table.emplace(number, factors);
+// All prime factors with multiplicity, or nothing for a prime like in the table file
+std::vector<BigUint> factorize(const BigUint &number, const factor::Factorizer &factorizer) {
+    if (number == BigUint::ZERO or number == BigUint::ONE) {
+        throw std::runtime_error("number cannot be zero or one");
     }
 
-    return factor_table;
+    auto factors = factorizer.factor(number);
+    if (factors.size() == 1) {
+        return {};
+    }
+    return factors;
 }
 
-void print_number_and_its_factors(const BigUint &number, const std::vector<BigUint> &factors) {
-    std::cout << number << ' ';
-    if (factors.empty()) {
-        std::cout << " is prime";
-    }
-    else {
-        std::cout << " = " << factors[0];
-        for (std::size_t ii = 1; ii < factors.size(); ii++) {
-            std::cout << " * " << factors[ii];
+// Factors the window [low, low + count) with one sieve pass, the numbers new to the table go to the journal
+std::chrono::duration<double, std::milli> factor_window(const uint64_t low, const uint64_t count, FactorTable &factor_table, PrimeNumbers &prime_numbers, FactorJournal &journal) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    const auto window = sieve::factor_range(low, low + count);
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t ii = 0; ii < count; ii++) {
+        const BigUint number = BigUint::from_native_word(low + ii);
+        std::vector<BigUint> factors;
+        if (window[ii].size() > 1) {
+            factors.reserve(window[ii].size());
+            for (const auto factor : window[ii]) {
+                factors.emplace_back(BigUint::from_native_word(factor));
+            }
+        }
+        else {
+            prime_numbers.push_back(low + ii);
         }
-    }
-}
 
-void summarize_factor_table(const FactorTable &factor_table) {
-    for (const auto &[number, factors] : factor_table) {
         print_number_and_its_factors(number, factors);
         std::cout << '\n';
+        if (factor_table.insert(number, factors)) {
+            journal.append(number, factors);
+        }
     }
+    return end - start;
 }
 
-void load_primes_from_table(const FactorTable &factor_table, PrimeNumbers &prime_numbers) {
-    for (const auto &[number, factors] : factor_table) {
-        if (factors.empty()) {
-            prime_numbers.push_back(number);
+constexpr uint64_t sweep_window = 10'000;
+constexpr uint64_t numbers_per_checkpoint = 1'000;
+
+// Factors checkpoint.remaining consecutive numbers from checkpoint.next. Every result goes through the journal, and the
+// checkpoint only moves on once the journal holds everything before checkpoint.next. An interrupted ECM stage is recorded
+// after every round of curves
+std::chrono::duration<double, std::milli> sweep(SweepCheckpoint checkpoint, FactorTable &factor_table, PrimeNumbers &prime_numbers, const std::filesystem::path &path,
+                                                const std::filesystem::path &checkpoint_path) {
+    std::chrono::duration<double, std::milli> factoring_duration{};
+    const auto journal_path = std::filesystem::path(path).replace_extension(".journal");
+    {
+        // results reach the disk in batches, a crash loses at most what came after the last checkpoint
+        FactorJournal journal(journal_path);
+        while (checkpoint.window > 0 && checkpoint.remaining > 0) {
+            const uint64_t count = std::min(checkpoint.window, checkpoint.remaining);
+            const auto low = checkpoint.next.as_native_word();
+            if (!low || *low > std::numeric_limits<uint64_t>::max() - count) {
+                checkpoint.window = 0;
+                break;
+            }
+            factoring_duration += factor_window(*low, count, factor_table, prime_numbers, journal);
+            journal.flush();
+            checkpoint.next = BigUint::from_native_word(*low + count);
+            checkpoint.remaining -= count;
+            checkpoint.save(checkpoint_path);
+        }
+
+        if (checkpoint.remaining > 0) {
+            const auto factorizer = make_factorizer(factor_table, std::thread::hardware_concurrency(), nullptr, checkpoint.ecm_progress(journal, checkpoint_path));
+            for (uint64_t steps = 1; checkpoint.remaining > 0; steps++) {
+                const BigUint number = checkpoint.next;
+                const auto start = std::chrono::high_resolution_clock::now();
+                const auto factors = factorize(number, factorizer);
+                auto end = std::chrono::high_resolution_clock::now();
+                factoring_duration += (end - start);
+                if (const auto word = number.as_native_word(); factors.empty() && word) {
+                    prime_numbers.push_back(*word);
+                }
+                if (factor_table.insert(number, factors)) {
+                    journal.append(number, factors);
+                }
+                print_number_and_its_factors(number, factors);
+                std::cout << '\n';
+
+                checkpoint.next = number.plus_one();
+                checkpoint.remaining--;
+                checkpoint.ecm.reset();
+                if (steps % numbers_per_checkpoint == 0 || checkpoint.remaining == 0) {
+                    journal.flush();
+                    checkpoint.save(checkpoint_path);
+                }
+            }
         }
     }
+
+    fold_journal(journal_path, path, [](const BigUint &, const std::vector<BigUint> &) { return true; });
+    std::filesystem::remove(checkpoint_path);
+    return factoring_duration;
 }
 
-BigUint next_prime(const PrimeNumbers &prime_numbers, const BigUint &prime) {
-    auto itr = prime_numbers.begin();
-    while (*itr != prime && itr != prime_numbers.end()) {
-        ++itr;
+// Reads one base 10 number per line, blank lines are skipped. Other lines are reported and skipped, counted in invalid
+std::vector<BigUint> read_numbers(std::istream &in, std::size_t &invalid) {
+    std::vector<BigUint> numbers;
+    std::string line;
+    for (std::size_t line_number = 1; std::getline(in, line); line_number++) {
+        std::istringstream iss(line);
+        std::string token;
+        std::string extra;
+        if (!(iss >> token)) {
+            continue;
+        }
+        try {
+            if (iss >> extra) {
+                throw std::runtime_error("more than one number");
+            }
+            numbers.push_back(BigUint::from_base10_string(token));
+        } catch (const std::exception &) {
+            std::cerr << "line " << line_number << ": invalid number\n";
+            invalid++;
+        }
     }
+    return numbers;
+}
 
-    if (itr == prime_numbers.end()) {
-        std::string message = "Could not find prime ";
-        message += prime.to_base10_string();
-        throw std::runtime_error(message.c_str());
+// Factors the numbers of the input file, or of stdin without one, on every core and prints them in input order
+template <typename Table>
+int factor_batch(const std::string &input_path, const Table &factor_table) {
+    std::vector<BigUint> numbers;
+    std::size_t invalid = 0;
+    if (input_path.empty()) {
+        numbers = read_numbers(std::cin, invalid);
     }
-
-    ++itr;
-    if (itr == prime_numbers.end()) {
-        std::string message = "Could not get next prime to ";
-        message += prime.to_base10_string();
-        throw std::runtime_error(message.c_str());
+    else {
+        std::ifstream fin(input_path);
+        if (!fin) {
+            std::cerr << "Could not open file " << input_path << '\n';
+            return 1;
+        }
+        numbers = read_numbers(fin, invalid);
     }
 
-    return *itr;
+    // every number gets one core, the pool keeps all of them busy and repeated numbers come from the cache
+    FactorCache cache;
+    const auto factorizer = make_factorizer(factor_table, 1, &cache);
+    try {
+        (void) factorizer.factor_all(numbers, std::thread::hardware_concurrency(), [&numbers, &cache](const std::size_t index, const std::optional<std::vector<BigUint>> &factors) {
+            if (!factors) {
+                std::cout << numbers[index] << "  could not be factored\n";
+                return;
+            }
+            if (factors->size() > 1) {
+                (void) cache.insert(numbers[index], *factors);
+            }
+            if (numbers[index] <= BigUint::ONE) {
+                std::cout << numbers[index] << "  has no prime factors\n";
+                return;
+            }
+            print_number_and_its_factors(numbers[index], factors->size() == 1 ? std::vector<BigUint>{} : *factors);
+            std::cout << '\n';
+        });
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return invalid == 0 ? 0 : 1;
 }
 
-std::vector<BigUint> factorize(const BigUint &number, const FactorTable &factor_table, const PrimeNumbers &prime_numbers) {
-    if (number == BigUint::ZERO or number == BigUint::ONE) {
-        throw std::runtime_error("number cannot be zero or one");
+// Service mode state. The table stays as loaded, new results go to the concurrent cache and to the journal for the next start
+struct Service {
+    FactorTable factor_table;
+    FactorCache cache;
+    PrimeNumbers prime_numbers;
+    FactorJournal journal;
+    factor::Factorizer factorizer;
+
+    Service(FactorTable table, PrimeNumbers primes, const std::filesystem::path &journal_path)
+        : factor_table(std::move(table)), prime_numbers(std::move(primes)), journal(journal_path),
+          factorizer(make_factorizer(factor_table, 1, &cache)) {
     }
 
-    const auto itr = factor_table.find(number);
-    if (itr != factor_table.end()) {
-        return itr->second;
+    [[nodiscard]] BigUint next_prime_after(const BigUint &number) const {
+        if (const auto word = number.as_native_word(); word && !prime_numbers.empty() && *word < prime_numbers.back()) {
+            return BigUint::from_native_word(next_prime(prime_numbers, *word));
+        }
+        if (number < BigUint::TWO) {
+            return BigUint::TWO;
+        }
+        BigUint candidate = number.plus_one();
+        if (candidate.is_even()) {
+            candidate.me_plus_one();
+        }
+        while (!primality::is_prime(candidate)) {
+            candidate += BigUint::DigitType{2};
+        }
+        return candidate;
     }
 
-    BigUint possible_divisor = BigUint::TWO;
-    BigUint possible_quotient = BigUint::ZERO;
-    bool found_divisor = false;
-    while (!found_divisor && possible_divisor.square() <= number) {
-        const auto [quotient, remainder] = number.divide_by(possible_divisor);
-        if (remainder == BigUint::ZERO) {
-            found_divisor = true;
-            possible_quotient = quotient;
+    // One reply line per request line. The factor requests of a batch are spread over every core together
+    std::vector<std::string> answer(const std::vector<std::string> &requests) {
+        std::vector<std::string> replies(requests.size());
+        std::vector<BigUint> numbers;
+        std::vector<std::size_t> slots;
+        for (std::size_t ii = 0; ii < requests.size(); ii++) {
+            std::istringstream iss(requests[ii]);
+            std::string command;
+            std::string argument;
+            std::string extra;
+            iss >> command >> argument;
+            if (iss >> extra) {
+                replies[ii] = "error unexpected " + extra + " after " + argument;
+                continue;
+            }
+            BigUint number;
+            try {
+                number = BigUint::from_base10_string(argument);
+            } catch (const std::exception &e) {
+                replies[ii] = std::string("error ") + e.what();
+                continue;
+            }
+
+            if (command == "factor") {
+                numbers.push_back(std::move(number));
+                slots.push_back(ii);
+            }
+            else if (command == "is_prime") {
+                replies[ii] = primality::is_prime(number) ? "true" : "false";
+            }
+            else if (command == "next_prime") {
+                replies[ii] = next_prime_after(number).to_base10_string();
+            }
+            else {
+                replies[ii] = "error unknown command " + command;
+            }
         }
-        else {
-            possible_divisor = next_prime(prime_numbers, possible_divisor);
+
+        try {
+            (void) factorizer.factor_all(numbers, std::thread::hardware_concurrency(), [&](const std::size_t index, const std::optional<std::vector<BigUint>> &factors) {
+                if (!factors) {
+                    replies[slots[index]] = "error could not factor " + numbers[index].to_base10_string();
+                    return;
+                }
+                if (factors->empty()) {
+                    replies[slots[index]] = "error " + numbers[index].to_base10_string() + " has no prime factors";
+                    return;
+                }
+                std::string &reply = replies[slots[index]];
+                for (const auto &factor : *factors) {
+                    reply += (reply.empty() ? "" : " ") + factor.to_base10_string();
+                }
+
+                auto table_factors = factors->size() == 1 ? std::vector<BigUint>{} : *factors;
+                if (!factor_table.contains(numbers[index]) && cache.insert(numbers[index], table_factors)) {
+                    journal.append(numbers[index], table_factors);
+                }
+            });
+        } catch (const std::exception &e) {
+            for (const auto slot : slots) {
+                if (replies[slot].empty()) {
+                    replies[slot] = std::string("error ") + e.what();
+                }
+            }
         }
+        return replies;
     }
+};
+
+long read_some(const int descriptor, char *buffer, const std::size_t size) {
+#ifdef _WIN32
+    return _read(descriptor, buffer, static_cast<unsigned>(size));
+#else
+    return static_cast<long>(read(descriptor, buffer, size));
+#endif
+}
 
-    if (!found_divisor) {
-        return {};
+// False once the other end is gone, EPIPE with SIGPIPE ignored
+bool write_all(const int descriptor, const std::string &text) {
+    for (std::size_t written = 0; written < text.size();) {
+#ifdef _WIN32
+        const long count = _write(descriptor, text.data() + written, static_cast<unsigned>(text.size() - written));
+#else
+        const long count = static_cast<long>(write(descriptor, text.data() + written, text.size() - written));
+#endif
+        if (count <= 0) {
+            return false;
+        }
+        written += static_cast<std::size_t>(count);
     }
+    return true;
+}
 
-    auto factors = factor_table.at(possible_quotient);
-    if (factors.empty()) {
-        factors.emplace_back(possible_quotient);
+// Line protocol on a pair of descriptors, every complete line that arrived with one read is answered as one batch
+void serve_lines(const int in, const int out, Service &service) {
+    std::string pending;
+    std::vector<char> buffer(1 << 16);
+    bool open = true;
+    while (open) {
+        const long count = read_some(in, buffer.data(), buffer.size());
+        open = count > 0;
+        if (open) {
+            pending.append(buffer.data(), static_cast<std::size_t>(count));
+        }
+        else if (!pending.empty()) {
+            pending += '\n'; // a last request without a line break
+        }
+
+        std::vector<std::string> requests;
+        std::size_t begin = 0;
+        for (std::size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', begin)) {
+            std::string line = pending.substr(begin, end - begin);
+            begin = end + 1;
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                requests.push_back(std::move(line));
+            }
+        }
+        pending.erase(0, begin);
+        if (requests.empty()) {
+            continue;
+        }
+
+        std::string reply;
+        for (const auto &line : service.answer(requests)) {
+            reply += line;
+            reply += '\n';
+        }
+        if (!write_all(out, reply)) {
+            return;
+        }
     }
-    factors.emplace_back(possible_divisor);
-    std::ranges::sort(factors);
-    return factors;
 }
 
-void write_number_and_factors_at_the_end_of_file(const BigUint &number, const std::vector<BigUint> &factors, const std::filesystem::path &path) {
-    std::ofstream out(path, std::ios::app);
-    if (!out) {
-        throw std::runtime_error("Could not open file " + path.string());
+#ifndef _WIN32
+volatile std::sig_atomic_t stop_serving = 0;
+
+extern "C" void request_stop(int) {
+    stop_serving = 1;
+}
+#endif
+
+// Loads the table and the primes once, then answers requests on stdin or on a local Unix socket. The socket is served
+// until SIGINT or SIGTERM, then removed
+int serve(const std::string &socket_path, const std::filesystem::path &table_path) {
+#ifndef _WIN32
+    // a client that goes away before its reply fails that write with EPIPE instead of killing the service
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    const auto journal_path = std::filesystem::path(table_path).replace_extension(".journal");
+    FactorTable factor_table;
+    try {
+        undo_interrupted_fold(journal_path, table_path);
+        factor_table = FactorTable::from_text_file(table_path, std::thread::hardware_concurrency());
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+    }
+    PrimeNumbers prime_numbers;
+    try {
+        fold_journal(journal_path, table_path, [&factor_table](const BigUint &number, const std::vector<BigUint> &factors) {
+            return factor_table.insert(number, factors);
+        });
+        // next_prime answers from the sieve over the dense run, sparse entries may be far too large to sieve to
+        if (!factor_table.smallest_factors().empty()) {
+            load_primes_from_sieve(dense_end(factor_table), prime_numbers);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+    }
+
+    Service service(std::move(factor_table), std::move(prime_numbers), journal_path);
+    std::cerr << "ready, " << service.factor_table.size() << " numbers in the table\n";
+    if (socket_path.empty()) {
+        serve_lines(0, 1, service);
+        return 0;
     }
 
-    out << '\n' << number;
-    if (!factors.empty()) {
-        for (const auto &factor : factors) {
-            out << ' ' << factor;
+#ifdef _WIN32
+    std::cerr << "Unix sockets are not supported on this platform, serve on stdin instead\n";
+    return 1;
+#else
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "socket path " << socket_path << " is too long\n";
+        return 1;
+    }
+    std::ranges::copy(socket_path, address.sun_path);
+
+    // a socket left by an earlier run is replaced, anything else at the path is not ours to delete
+    struct stat status{};
+    if (lstat(socket_path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            std::cerr << socket_path << " exists and is not a socket\n";
+            return 1;
         }
+        unlink(socket_path.c_str());
     }
 
-    out.close();
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        std::cerr << "Could not listen on " << socket_path << '\n';
+        return 1;
+    }
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    // Every client on its own thread, so an idle connection holds up nobody and batches of different clients share
+    // the pool. The listener is polled so a stop request is seen, then the open connections are shut down
+    std::mutex clients_mutex;
+    std::condition_variable clients_done;
+    std::vector<int> clients;
+    while (stop_serving == 0) {
+        pollfd entry{listener, POLLIN, 0};
+        if (poll(&entry, 1, 250) <= 0) {
+            continue;
+        }
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        const std::lock_guard lock(clients_mutex);
+        clients.push_back(client);
+        std::thread([&, client] {
+            serve_lines(client, client, service);
+            const std::lock_guard lock(clients_mutex);
+            std::erase(clients, client);
+            close(client);
+            clients_done.notify_all();
+        }).detach();
+    }
+    {
+        std::unique_lock lock(clients_mutex);
+        for (const int client : clients) {
+            shutdown(client, SHUT_RDWR);
+        }
+        clients_done.wait(lock, [&clients] { return clients.empty(); });
+    }
+    close(listener);
+    unlink(socket_path.c_str());
+    return 0;
+#endif
 }
 
 constexpr bool show_factor_table = false;
 constexpr bool show_prime_numbers = true;
 constexpr bool factor_more_numbers = false;
 
-int main() {
+// Batch mode maps the binary table next to the text one when there is one, and parses the text table otherwise
+int factor_batch(const std::string &input_path, const std::filesystem::path &table_path) {
+    auto binary_path = table_path;
+    binary_path.replace_extension(".bin");
+    if (std::filesystem::exists(binary_path)) {
+        try {
+            const MappedFactorTable factor_table(binary_path);
+            return factor_batch(input_path, factor_table);
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    FactorTable factor_table;
+    try {
+        factor_table = FactorTable::from_text_file(table_path, std::thread::hardware_concurrency());
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+    }
+    return factor_batch(input_path, factor_table);
+}
+
+// factorization                        explores the factor table
+// factorization --batch [file]         factors one number per line of the file or of stdin
+// factorization --serve [socket]       answers factor N, is_prime N and next_prime N lines on stdin or a Unix socket
+// factorization --to-binary text bin   converts a text table to the binary format
+// factorization --to-text bin text     converts a binary table back to text
+int main(const int argc, char *argv[]) {
     const std::filesystem::path resource_dir_path = RSC_PATH;
     const std::filesystem::path file_path = !resource_dir_path.empty() ? resource_dir_path / "dev-factorization.txt" : "resources/factorization.txt";
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return factor_batch(argc > 2 ? argv[2] : "", file_path);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        return serve(argc > 2 ? argv[2] : "", file_path);
+    }
+    if (argc == 4 && (std::string(argv[1]) == "--to-binary" || std::string(argv[1]) == "--to-text")) {
+        try {
+            if (std::string(argv[1]) == "--to-binary") {
+                convert_text_to_binary(argv[2], argv[3]);
+            }
+            else {
+                convert_binary_to_text(argv[2], argv[3]);
+            }
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
     std::cout << "Working with " << file_path.string() << "\n";
     std::cout << std::endl;
 
+    // a preempted sweep goes on where it stopped, without reading the table it already committed
+    const std::filesystem::path checkpoint_path = std::filesystem::path(file_path).replace_extension(".checkpoint");
+    const std::filesystem::path journal_path = std::filesystem::path(file_path).replace_extension(".journal");
+    if constexpr (factor_more_numbers) {
+        try {
+            if (const auto checkpoint = SweepCheckpoint::load(checkpoint_path)) {
+                std::cout << "Resuming the sweep at " << checkpoint->next << " with " << checkpoint->remaining << " numbers to go\n";
+                checkpoint->fold_committed(journal_path, file_path);
+                FactorTable factor_table;
+                PrimeNumbers prime_numbers;
+                const auto factoring_duration = sweep(*checkpoint, factor_table, prime_numbers, file_path, checkpoint_path);
+                std::cout << '\n' << checkpoint->remaining << " numbers has been factorized in " << factoring_duration.count() << " ms\n";
+                return 0;
+            }
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+
     FactorTable factor_table;
     try {
-        factor_table = build_factor_table_from_file(file_path);
+        undo_interrupted_fold(journal_path, file_path);
+        factor_table = FactorTable::from_text_file(file_path, std::thread::hardware_concurrency());
+    } catch (const std::exception &e) {
+        std::cout << e.what() << '\n';
+    }
+
+    // results journaled by a run that did not get to fold them into the text table
+    try {
+        fold_journal(journal_path, file_path, [&factor_table](const BigUint &number, const std::vector<BigUint> &factors) {
+            return factor_table.insert(number, factors);
+        });
     } catch (const std::exception &e) {
         std::cout << e.what() << '\n';
     }
@@ -201,8 +643,15 @@ int main() {
         summarize_factor_table(factor_table);
     }
 
+    // the primes of the dense run only, like the service does
     PrimeNumbers prime_numbers;
-    load_primes_from_table(factor_table, prime_numbers);
+    try {
+        if (!factor_table.smallest_factors().empty()) {
+            load_primes_from_sieve(dense_end(factor_table), prime_numbers);
+        }
+    } catch (const std::exception &e) {
+        std::cout << e.what() << '\n';
+    }
 
     if constexpr (show_prime_numbers) {
         std::cout << '\n';
@@ -213,32 +662,28 @@ int main() {
         for (auto &prime_number : prime_numbers) {
             std::cout << prime_number << '\n';
         }
-        std::cout << "There are " << prime_numbers_size << " primes between " << factor_table.begin()->first << " and " << factor_table.rbegin()->first << "\n";
+        if (!factor_table.smallest_factors().empty()) {
+            std::cout << "There are " << prime_numbers_size << " primes below " << dense_end(factor_table) << "\n";
+        }
     }
 
     if constexpr (factor_more_numbers) {
         std::cout << '\n';
         std::cout << "Factoring...\n";
         std::cout << "------------\n";
-        constexpr int number_of_steps = 100'000;
-        std::chrono::duration<double, std::milli> factoring_duration{};
-        for (int steps = 1; steps <= number_of_steps; steps++) {
-            BigUint number = factor_table.rbegin()->first;
-            number.me_plus_one();
-            const auto start = std::chrono::high_resolution_clock::now();
-            const auto factors = factorize(number, factor_table, prime_numbers);
-            auto end = std::chrono::high_resolution_clock::now();
-            factoring_duration += (end - start);
-            factor_table.emplace_hint(factor_table.end(), number, factors);
-            if (factors.empty()) {
-                prime_numbers.push_back(number);
-            }
-            write_number_and_factors_at_the_end_of_file(number, factors, file_path);
-            print_number_and_its_factors(number, factors);
-            std::cout << '\n';
+        constexpr uint64_t number_of_steps = 100'000;
+        SweepCheckpoint checkpoint;
+        // the sweep extends the dense run, a sparse key far beyond it is no place to start
+        checkpoint.next = factor_table.smallest_factors().empty() ? BigUint::TWO : dense_end(factor_table);
+        checkpoint.remaining = number_of_steps;
+        checkpoint.window = sweep_window;
+        try {
+            const auto factoring_duration = sweep(checkpoint, factor_table, prime_numbers, file_path, checkpoint_path);
+            std::cout << '\n' << number_of_steps << " numbers has been factorized in " << factoring_duration.count() << " ms\n";
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << '\n';
+            return 1;
         }
-
-        std::cout << '\n' << number_of_steps << " numbers has been factorized in " << factoring_duration.count() << " ms\n";
     }
 
     return 0;
@@ -0,0 +1,24 @@
+#ifndef BATCH_GCD_H
+#define BATCH_GCD_H
+
+#include "BigUint.h"
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Bernstein's batch GCD, finds the moduli sharing a factor with any other modulus without pairwise gcds
+namespace batch_gcd
+{
+    // levels[0] holds the moduli, every next level the products of adjacent pairs of the previous one
+    using ProductTree = std::vector<std::vector<BigUint>>;
+
+    [[nodiscard]] ProductTree build_product_tree(std::span<const BigUint> moduli);
+
+    // gcd(modulus, product of all the other moduli) for every modulus, one when it shares no factor
+    [[nodiscard]] std::vector<BigUint> shared_factors(std::span<const BigUint> moduli);
+
+    // Reads the first number of every line, same format as the factorization table files
+    [[nodiscard]] std::vector<BigUint> read_moduli_from_file(const std::filesystem::path &path);
+} // end namespace batch_gcd
+
+#endif //BATCH_GCD_H
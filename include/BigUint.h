@@ -6,6 +6,11 @@
 #include <iostream>
 #include <cstdint>
 #include <optional>
+#include <span>
+#include <utility>
+#include <functional>
+
+struct ExtendedGcd;
 
 class BigUint {
 public:
@@ -17,6 +22,8 @@ public:
     using ByteType = uint8_t;
     using ByteDigit = ByteType;
     static constexpr WideDigitType BASE = std::numeric_limits<DigitType>::max() + 1;
+    // word divisors of remainder_by_word stay below this, so a remainder shifted by one digit still fits in a word
+    static constexpr uint64_t WORD_DIVISOR_BOUND = uint64_t{1} << 48;
 
     BigUint(WideDigit digit = 0);
     explicit BigUint(const std::string& str);
@@ -36,6 +43,8 @@ public:
     [[nodiscard]] std::optional<DigitType> as_digit() const;
     [[nodiscard]] std::optional<WideDigitType> as_wide_digit() const;
     [[nodiscard]] std::optional<ByteType> as_byte_digit() const;
+    [[nodiscard]] std::optional<uint64_t> as_native_word() const;
+    static [[nodiscard]] BigUint from_native_word(uint64_t value);
 
     [[nodiscard]] Digit get_least_significant_digit() const { return digits_.front(); }
     [[nodiscard]] Digit get_most_significant_digit() const { return digits_.back(); }
@@ -59,6 +68,16 @@ public:
 
     void shift_me_left(size_t shiftPositions);
     [[nodiscard]] BigUint shift_left(size_t shiftPositions) const;
+    void shift_me_right(size_t shiftPositions);
+    [[nodiscard]] BigUint shift_right(size_t shiftPositions) const;
+
+    // Bit level shifts and queries
+    void shift_me_left_bits(size_t shiftBits);
+    [[nodiscard]] BigUint shift_left_bits(size_t shiftBits) const;
+    void shift_me_right_bits(size_t shiftBits);
+    [[nodiscard]] BigUint shift_right_bits(size_t shiftBits) const;
+    [[nodiscard]] std::size_t bit_length() const;
+    [[nodiscard]] std::size_t count_trailing_zeros() const;
 
     void me_plus_one();
     [[nodiscard]] BigUint plus_one() const;
@@ -104,6 +123,13 @@ public:
     void pow_me_by(const BigUint &power);
     [[nodiscard]] BigUint pow_by(const BigUint &power) const;
 
+    // floor(sqrt(this))
+    [[nodiscard]] BigUint isqrt() const;
+    // floor(this^(1 / k)), Newton's iteration from a floating point estimate of the leading bits
+    [[nodiscard]] BigUint iroot(uint32_t k) const;
+    // base and the largest exponent above one with base^exponent = this, nullopt for a number that is no perfect power
+    [[nodiscard]] std::optional<std::pair<BigUint, uint32_t>> is_perfect_power() const;
+
     // returns the remainder
     BigUint::DigitType divide_me_by(DigitType digit);
     // returns quotient and remainder
@@ -116,6 +142,8 @@ public:
     BigUint::DigitType operator%=(DigitType digit);
     // returns the remainder
     [[nodiscard]] BigUint::DigitType operator%(DigitType) const;
+    // this mod divisor for 0 < divisor < WORD_DIVISOR_BOUND, without building the quotient
+    [[nodiscard]] uint64_t remainder_by_word(uint64_t divisor) const;
 
     // returns the remainder
     BigUint divide_me_by(const BigUint &rhs);
@@ -140,8 +168,21 @@ public:
     [[nodiscard]] BigUint modPow(const BigUint& other, const BigUint& mod) const;
     */
 
+    // Binary GCD for small operands, Lehmer GCD for larger ones and half GCD for huge ones
     static BigUint gcd(BigUint a, BigUint b);
     static BigUint lcm(const BigUint &a, const BigUint &b);
+    // gcd = a * x + b * y
+    static [[nodiscard]] ExtendedGcd extended_gcd(const BigUint &a, const BigUint &b);
+    // returns nullopt when value and mod are not coprime
+    static [[nodiscard]] std::optional<BigUint> mod_inverse(const BigUint &value, const BigUint &mod);
+    // Montgomery's trick, one inversion and about 3(N - 1) multiplications, returns nullopt when any value is not invertible.
+    // With threads > 1 the batch is split into chunks that are inverted in parallel
+    static [[nodiscard]] std::optional<std::vector<BigUint>> batch_mod_inverse(std::span<const BigUint> values, const BigUint &mod, std::size_t threads = 1);
+    // Jacobi symbol (a / n) for an odd n by the binary algorithm, shifts and subtractions instead of divisions
+    static [[nodiscard]] int jacobi(BigUint a, BigUint n);
+    // x with x^2 = a (mod p) for an odd prime p, nullopt when a is not a quadratic residue.
+    // One exponentiation for p = 3 (mod 4) and p = 5 (mod 8), Tonelli-Shanks otherwise
+    static [[nodiscard]] std::optional<BigUint> mod_sqrt(const BigUint &a, const BigUint &p);
 
     friend class BigUintTestAccessor;
     friend class BigUintBenchmarkAccessor;
@@ -152,17 +193,54 @@ private:
     void remove_leading_zeros();
     [[nodiscard]] BigUint multiply_me_naive(const BigUint& other) const;
     static std::pair<BigUint, BigUint> divide_by(const BigUint &dividend, const BigUint &divisor);
+    static constexpr std::size_t NEWTON_DIVISION_MIN_DIGITS = 2'048;
+    static [[nodiscard]] BigUint reciprocal(const BigUint &divisor);
+    static [[nodiscard]] std::pair<BigUint, BigUint> newton_divide_by(const BigUint &dividend, const BigUint &divisor);
 
     // Multiplications
+    static constexpr std::size_t KARATSUBA_MIN_DIGITS = 96;
+    static constexpr std::size_t FFT_MIN_DIGITS = 384;
     [[nodiscard]] BigUint multiply_me_fft(const BigUint& other) const;
     [[nodiscard]] std::pair<BigUint, BigUint> split(std::size_t pos) const;
     [[nodiscard]] BigUint multiply_me_karatsuba(const BigUint& other) const;
 
+    // GCD
+    static constexpr std::size_t BINARY_GCD_MAX_DIGITS = 16;
+    static [[nodiscard]] BigUint binary_gcd(BigUint a, BigUint b);
+    static [[nodiscard]] BigUint lehmer_gcd(BigUint a, BigUint b);
+    static constexpr std::size_t HALF_GCD_MIN_DIGITS = 40'960;
+    static [[nodiscard]] BigUint subquadratic_gcd(BigUint a, BigUint b);
+    static [[nodiscard]] std::optional<BigUint> binary_mod_inverse(BigUint value, const BigUint &mod);
+    static [[nodiscard]] bool batch_mod_inverse_chunk(std::span<const BigUint> values, const BigUint &mod, std::span<BigUint> inverses);
+
     // Helpers
     static [[nodiscard]] std::vector<BigUint::DigitType> opt_inner_square(const std::vector<BigUint::DigitType> &digits);
+    static void subtract_in_place(Digits &lhs, const Digits &rhs);
 };
 
 std::ostream& operator<<(std::ostream& os, const BigUint& bigUint);
 std::istream& operator>>(std::istream& is, BigUint& bigUint);
 
+// Signed value as a BigUint magnitude plus a sign, zero is never negative
+struct SignedBigUint {
+    BigUint magnitude;
+    bool negative = false;
+
+    bool operator==(const SignedBigUint& other) const = default;
+
+    // representative in [0, mod)
+    [[nodiscard]] BigUint mod(const BigUint &mod) const;
+};
+
+struct ExtendedGcd {
+    BigUint gcd;
+    SignedBigUint x;
+    SignedBigUint y;
+};
+
+template <>
+struct std::hash<BigUint> {
+    std::size_t operator()(const BigUint &value) const noexcept;
+};
+
 #endif // BigUint_H
@@ -0,0 +1,18 @@
+#ifndef ECM_H
+#define ECM_H
+
+#include "BigUint.h"
+#include <cstdint>
+#include <optional>
+
+namespace factor
+{
+    // Lenstra's elliptic curve method on Montgomery curves with Suyama's parametrization and x-only arithmetic.
+    // Stage 1 multiplies by every prime power up to b1, stage 2 covers single primes up to b2 with baby and giant steps.
+    // Curves are spread over threads and the first divisor found stops all of them, nullopt once every curve failed.
+    // Curve ii always uses the same sigma, so a run cut short goes on with first_curve set to the curves it finished
+    [[nodiscard]] std::optional<BigUint> ecm(const BigUint &number, uint64_t b1 = 11'000, uint64_t b2 = 1'100'000, std::size_t curves = 100, std::size_t threads = 1,
+                                             std::size_t first_curve = 0);
+} // end namespace factor
+
+#endif //ECM_H
@@ -0,0 +1,53 @@
+#ifndef FACTOR_CACHE_H
+#define FACTOR_CACHE_H
+
+#include "BigUint.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// Factorizations shared by factoring threads. Numbers hash to one of many shards, each behind its own reader writer
+// lock, so lookups only ever wait for an insert into the same shard. Once the entries pass the byte budget they are
+// evicted by the clock algorithm, an approximation of least recently used where a hit only sets a flag
+class FactorCache {
+public:
+    explicit FactorCache(std::size_t max_bytes = std::size_t{256} << 20, std::size_t shards = 64);
+
+    // Prime factors as they were inserted, empty for a prime, nullopt for an unknown or evicted number
+    [[nodiscard]] std::optional<std::vector<BigUint>> find(const BigUint &number) const;
+    // Keeps the existing factors when the number is already cached, returns whether it was added.
+    // An entry larger than the budget of its shard is not cached at all
+    bool insert(const BigUint &number, std::vector<BigUint> factors);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t bytes() const;
+
+private:
+    struct Entry {
+        BigUint number;
+        std::vector<BigUint> factors;
+        std::size_t bytes = 0;
+        mutable std::atomic<bool> referenced{false};
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<BigUint, std::size_t> positions; // into entries
+        std::vector<std::unique_ptr<Entry>> entries;         // the clock, evicted entries are replaced by the last one
+        std::size_t hand = 0;
+        std::size_t bytes = 0;
+    };
+
+    std::size_t shardCount_;
+    std::size_t shardBytes_;
+    std::unique_ptr<Shard[]> shards_;
+
+    [[nodiscard]] Shard & shard_of(const BigUint &number) const;
+    static void evict(Shard &shard, std::size_t budget);
+};
+
+#endif //FACTOR_CACHE_H
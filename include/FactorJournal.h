@@ -0,0 +1,71 @@
+#ifndef FACTOR_JOURNAL_H
+#define FACTOR_JOURNAL_H
+
+#include "BigUint.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// When the journal hands its buffer to the file, whichever limit is reached first
+struct JournalOptions {
+    std::size_t flush_records = 4'096;
+    std::chrono::milliseconds flush_interval{1'000};
+    std::size_t buffer_bytes = 1 << 20;
+    bool fsync = false; // also force every flush to the disk
+};
+
+// Append only log of factorizations. Every record is its payload size, the CRC-32 of the payload and the payload,
+// the number and its factors in base 10, so a record torn by a crash is recognized and dropped on replay.
+// Factoring threads push encoded records on a lock free stack, one writer thread drains it into a large buffer
+class FactorJournal {
+public:
+    using Visit = std::function<void(const BigUint &, const std::vector<BigUint> &)>;
+
+    explicit FactorJournal(const std::filesystem::path &path, JournalOptions options = {});
+    // Writes everything appended so far
+    ~FactorJournal();
+    FactorJournal(const FactorJournal &) = delete;
+    FactorJournal & operator=(const FactorJournal &) = delete;
+
+    // Safe to call from any number of threads, never waits for the file
+    void append(const BigUint &number, const std::vector<BigUint> &factors);
+    // Returns once every record appended before the call is in the file, throws when writing failed
+    void flush();
+
+    // Calls visit for every intact record in file order and cuts the file after the last one, returns the record count
+    static std::size_t replay(const std::filesystem::path &path, const Visit &visit);
+
+private:
+    struct Node {
+        std::string record;
+        Node *next = nullptr;
+    };
+
+    JournalOptions options_;
+    std::filesystem::path path_;
+    std::FILE *file_ = nullptr;
+    std::atomic<Node *> pending_{nullptr};
+    std::atomic<uint64_t> appended_{0};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    uint64_t flushRequested_ = 0;
+    uint64_t flushServed_ = 0;
+    bool failed_ = false;
+    bool stop_ = false;
+    std::thread writer_;
+
+    void write_loop();
+    // Drains the stack into the file oldest record first, false when the file refused any of it
+    bool write_pending(std::string &buffer);
+};
+
+#endif //FACTOR_JOURNAL_H
@@ -0,0 +1,94 @@
+#ifndef FACTOR_TABLE_H
+#define FACTOR_TABLE_H
+
+#include "BigUint.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Factorizations keyed by number in two flat stores. A contiguous run of word sized numbers keeps only the smallest
+// prime factor of each number, four bytes per entry, and derives the rest on lookup. Every other number lives in an
+// open addressing hash table whose factors share one flat array. Primes are stored without factors, like in the table file
+class FactorTable {
+public:
+    FactorTable() = default;
+
+    // Reads the text table, one line per number holding the number and then its prime factors, nothing for a prime.
+    // The file is mapped and cut into line aligned chunks that threads parse without iostreams, then merged in file order
+    static [[nodiscard]] FactorTable from_text_file(const std::filesystem::path &path, std::size_t threads = 1);
+    void write_text_file(const std::filesystem::path &path) const;
+
+    // Adds [low, high) by sieving smallest prime factors, low has to continue the dense run or start it when it is empty
+    void add_range(uint64_t low, uint64_t high);
+
+    // Keeps the existing factors when the number is already known, returns whether it was added
+    bool insert(const BigUint &number, const std::vector<BigUint> &factors);
+
+    // Prime factors in ascending order, empty for a prime, nullopt for an unknown number
+    [[nodiscard]] std::optional<std::vector<BigUint>> find(const BigUint &number) const;
+    [[nodiscard]] bool contains(const BigUint &number) const;
+
+    [[nodiscard]] std::size_t size() const { return smallestFactors_.size() + sparseSize_; }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] std::optional<BigUint> smallest() const;
+    [[nodiscard]] std::optional<BigUint> largest() const;
+
+    // The dense run, smallest prime factors of denseLow() onwards with zero marking a prime
+    [[nodiscard]] uint64_t dense_low() const { return denseLow_; }
+    [[nodiscard]] std::span<const uint32_t> smallest_factors() const { return smallestFactors_; }
+
+    // Factors of number from the smallest prime factors of the run starting at low, a quotient below the run is factored directly
+    static [[nodiscard]] std::vector<BigUint> factors_from_smallest(std::span<const uint32_t> smallestFactors, uint64_t low, uint64_t number);
+
+    // Calls visit(number, factors) for every entry outside the dense run in ascending order of the numbers
+    template <typename Visit>
+    void for_each_sparse(Visit &&visit) const {
+        for (const auto slot : sparse_order()) {
+            visit(slots_[slot].number, sparse_factors(slots_[slot]));
+        }
+    }
+
+    // Calls visit(number, factors) for every entry in ascending order of the numbers
+    template <typename Visit>
+    void for_each(Visit &&visit) const {
+        const auto order = sparse_order();
+        auto itr = order.begin();
+        const auto visit_sparse_below = [&](const std::optional<BigUint> &bound) {
+            for (; itr != order.end() && (!bound || slots_[*itr].number < *bound); ++itr) {
+                visit(slots_[*itr].number, sparse_factors(slots_[*itr]));
+            }
+        };
+        for (std::size_t ii = 0; ii < smallestFactors_.size(); ii++) {
+            const BigUint number = BigUint::from_native_word(denseLow_ + ii);
+            visit_sparse_below(number);
+            visit(number, *find(number));
+        }
+        visit_sparse_below(std::nullopt);
+    }
+
+private:
+    struct Slot {
+        BigUint number;
+        uint32_t first = 0; // factors_[first, first + count)
+        uint32_t count = 0;
+        bool used = false;
+    };
+
+    uint64_t denseLow_ = 0;
+    std::vector<uint32_t> smallestFactors_; // zero marks a prime
+    std::vector<Slot> slots_;
+    std::size_t sparseSize_ = 0;
+    std::vector<BigUint> factors_;
+
+    [[nodiscard]] std::optional<uint64_t> dense_index(const BigUint &number) const;
+    [[nodiscard]] std::vector<BigUint> dense_factors(uint64_t number) const;
+    [[nodiscard]] std::vector<BigUint> sparse_factors(const Slot &slot) const;
+    [[nodiscard]] std::vector<std::size_t> sparse_order() const;
+    [[nodiscard]] std::size_t find_slot(const BigUint &number) const;
+    void grow();
+};
+
+#endif //FACTOR_TABLE_H
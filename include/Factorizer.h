@@ -0,0 +1,71 @@
+#ifndef FACTORIZER_H
+#define FACTORIZER_H
+
+#include "BigUint.h"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace factor
+{
+    // Effort budgets of the pipeline stages, a zero budget skips its stage
+    struct FactorizerOptions {
+        uint32_t trial_division_bound = 1 << 16;
+        uint64_t rho_iterations = 1 << 20;
+        uint64_t ecm_b1 = 11'000;
+        uint64_t ecm_b2 = 1'100'000;
+        std::size_t ecm_curves = 50;
+        std::size_t siqs_max_digits = 100;
+        std::size_t threads = 1;
+    };
+
+    // Lets a long ECM stage be checkpointed. done tells how many curves at b1 an earlier run already finished on a number,
+    // record is told after every round of curves. Both are called from the thread factoring the number
+    struct EcmProgress {
+        std::function<std::size_t(const BigUint &number, uint64_t b1)> done;
+        std::function<void(const BigUint &number, uint64_t b1, std::size_t curves)> record;
+    };
+
+    // Table lookup, small primes by batched remainders, primality test, perfect powers, Pollard rho, ECM and SIQS,
+    // in that order. Every divisor found is fed back into the pipeline until only primes are left
+    class Factorizer {
+    public:
+        // Known factorizations, an empty vector marks a prime. Called from several threads by factor_all
+        using Lookup = std::function<std::optional<std::vector<BigUint>>(const BigUint &)>;
+        // Receives the input index and the factors of every number, nullopt for a number that could not be factored
+        using Emit = std::function<void(std::size_t, const std::optional<std::vector<BigUint>> &)>;
+
+        explicit Factorizer(FactorizerOptions options = {}, Lookup lookup = {}, EcmProgress progress = {});
+
+        // Prime factors in ascending order, repeated by multiplicity, empty for zero and one.
+        // Throws when a composite survives every stage within its budget
+        [[nodiscard]] std::vector<BigUint> factor(const BigUint &number) const;
+
+        // factor() of every number on threads with their own work queues that steal from each other once idle,
+        // since one number may take microseconds and the next hours. emit is called in input order as soon as every
+        // earlier number is done. The first exception of any number is rethrown after all threads finished and every
+        // number was emitted
+        std::vector<std::vector<BigUint>> factor_all(std::span<const BigUint> numbers, std::size_t threads, const Emit &emit = {}) const;
+
+    private:
+        struct PrimeGroup {
+            uint64_t product;
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        FactorizerOptions options_;
+        Lookup lookup_;
+        EcmProgress progress_;
+        std::vector<uint32_t> primes_;
+        std::vector<PrimeGroup> groups_; // products of consecutive primes below 2^48
+
+        void factor_into(BigUint number, std::vector<BigUint> &factors) const;
+        void divide_small_primes(BigUint &number, std::vector<BigUint> &factors) const;
+        [[nodiscard]] std::optional<BigUint> find_divisor(const BigUint &number) const;
+    };
+} // end namespace factor
+
+#endif //FACTORIZER_H
@@ -0,0 +1,67 @@
+#ifndef MAPPED_FACTOR_TABLE_H
+#define MAPPED_FACTOR_TABLE_H
+
+#include "BigUint.h"
+#include "FactorTable.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Binary factor table file, all integers little endian:
+//   header   magic "FACTTAB", version, dense low, dense count, sparse count and the offsets of the three sections
+//   dense    one uint32 smallest prime factor per number of the dense run, zero for a prime
+//   index    one uint64 record offset per sparse number, in ascending order of the numbers
+//   records  varint byte count and bytes of the number, varint factor count, then byte count and bytes of every factor
+// The dense section and the index are used in place, so opening a table only maps it
+class MappedFactorTable {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    explicit MappedFactorTable(const std::filesystem::path &path);
+
+    // Same answers as FactorTable::find, sparse numbers are found by binary search over the index
+    [[nodiscard]] std::optional<std::vector<BigUint>> find(const BigUint &number) const;
+    [[nodiscard]] bool contains(const BigUint &number) const;
+
+    [[nodiscard]] std::size_t size() const { return smallestFactors_.size() + index_.size(); }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    // Calls visit(number, factors) for every entry in ascending order of the numbers
+    template <typename Visit>
+    void for_each(Visit &&visit) const {
+        std::size_t position = 0;
+        for (std::size_t ii = 0; ii < smallestFactors_.size(); ii++) {
+            const BigUint number = BigUint::from_native_word(denseLow_ + ii);
+            for (; position < index_.size() && key(position) < number; position++) {
+                visit(key(position), factors(position));
+            }
+            visit(number, FactorTable::factors_from_smallest(smallestFactors_, denseLow_, denseLow_ + ii));
+        }
+        for (; position < index_.size(); position++) {
+            visit(key(position), factors(position));
+        }
+    }
+
+private:
+    MappedFile file_;
+    uint64_t denseLow_ = 0;
+    std::span<const uint32_t> smallestFactors_;
+    std::span<const uint64_t> index_;
+    std::span<const unsigned char> records_;
+
+    [[nodiscard]] BigUint key(std::size_t position) const;
+    [[nodiscard]] std::vector<BigUint> factors(std::size_t position) const;
+    [[nodiscard]] std::optional<std::size_t> find_position(const BigUint &number) const;
+};
+
+// Writes the table in the binary format
+void write_binary_factor_table(const FactorTable &table, const std::filesystem::path &path);
+
+// Converters between the text table and the binary format
+void convert_text_to_binary(const std::filesystem::path &text, const std::filesystem::path &binary);
+void convert_binary_to_text(const std::filesystem::path &binary, const std::filesystem::path &text);
+
+#endif //MAPPED_FACTOR_TABLE_H
@@ -0,0 +1,29 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <filesystem>
+#include <span>
+
+// Read only mapping of a whole file, its pages are shared with every other process mapping the same file
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    // Empty for an empty file
+    [[nodiscard]] std::span<const unsigned char> bytes() const { return {data_, size_}; }
+
+private:
+    const unsigned char *data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void *file_ = nullptr;
+    void *mapping_ = nullptr;
+#endif
+
+    void unmap();
+};
+
+#endif //MAPPED_FILE_H
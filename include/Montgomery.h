@@ -0,0 +1,41 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include "BigUint.h"
+#include <cstdint>
+#include <vector>
+
+// Montgomery form modulo an odd BigUint: x is stored as x R mod n with R = 2^(32 words(n)),
+// so modular multiplications reduce without any division
+class Montgomery {
+public:
+    explicit Montgomery(const BigUint &mod);
+
+    [[nodiscard]] const BigUint & modulus() const { return mod_; }
+    [[nodiscard]] const BigUint & one() const { return one_; }
+
+    [[nodiscard]] BigUint to_montgomery(const BigUint &value) const;
+    [[nodiscard]] BigUint from_montgomery(const BigUint &value) const;
+
+    // Operands and results in Montgomery form
+    [[nodiscard]] BigUint multiply(const BigUint &lhs, const BigUint &rhs) const;
+    [[nodiscard]] BigUint square(const BigUint &value) const;
+    [[nodiscard]] BigUint add(const BigUint &lhs, const BigUint &rhs) const;
+    [[nodiscard]] BigUint subtract(const BigUint &lhs, const BigUint &rhs) const;
+    [[nodiscard]] BigUint half(const BigUint &value) const;
+    [[nodiscard]] BigUint pow(const BigUint &base, const BigUint &exponent) const;
+
+private:
+    using Word = uint32_t;
+    using Words = std::vector<Word>;
+
+    BigUint mod_;
+    Words modWords_;
+    Word inverse_; // -mod^-1 modulo 2^32
+    BigUint one_;
+    BigUint rSquared_;
+
+    [[nodiscard]] Words to_words(const BigUint &value) const;
+};
+
+#endif //MONTGOMERY_H
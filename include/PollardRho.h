@@ -0,0 +1,17 @@
+#ifndef POLLARD_RHO_H
+#define POLLARD_RHO_H
+
+#include "BigUint.h"
+#include <cstdint>
+#include <optional>
+
+namespace factor
+{
+    // A non trivial divisor of a composite, Pollard's rho with Brent's cycle detection on Montgomery arithmetic.
+    // Differences are multiplied together and only every batch of them costs a gcd. Each thread walks its own
+    // polynomials x^2 + c, the first divisor found stops all of them. Returns nullopt when every polynomial fails
+    // or runs out of max_iterations, which is also the answer for primes
+    [[nodiscard]] std::optional<BigUint> pollard_rho_brent(const BigUint &number, std::size_t threads = 1, uint64_t max_iterations = 1 << 22);
+} // end namespace factor
+
+#endif //POLLARD_RHO_H
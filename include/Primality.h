@@ -7,6 +7,7 @@ namespace primality
 {
     bool is_divisible_by(const BigUint &number, uint8_t divisor);
     bool is_divisible_by(const BigUint &number, const BigUint &divisor);
+    // Deterministic below 2^64, Baillie-PSW above, which has no known counterexample
     bool is_prime(const BigUint &number);
 } // end namespace primality
 
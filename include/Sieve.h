@@ -0,0 +1,31 @@
+#ifndef SIEVE_H
+#define SIEVE_H
+
+#include <cstdint>
+#include <vector>
+
+// Segmented sieve of Eratosthenes on a mod 30 wheel: one byte holds the eight numbers coprime to 30
+// in a block of thirty, and segments are sized to stay in the L1 cache
+namespace sieve
+{
+    // Primes in [low, high) in ascending order, threads > 1 sieves contiguous chunks in parallel
+    [[nodiscard]] std::vector<uint64_t> primes_in_range(uint64_t low, uint64_t high, std::size_t threads = 1);
+
+    // Primes below limit packed in 32 bits, half the memory of primes_in_range
+    [[nodiscard]] std::vector<uint32_t> primes_below(uint32_t limit, std::size_t threads = 1);
+
+    // Number of primes in [low, high) without storing them
+    [[nodiscard]] std::size_t count_primes(uint64_t low, uint64_t high, std::size_t threads = 1);
+
+    // Smallest prime factor of every number in [low, high), entry ii belongs to low + ii and is zero for 0 and 1
+    [[nodiscard]] std::vector<uint64_t> smallest_prime_factors(uint64_t low, uint64_t high);
+
+    // Prime factors of every number in [low, high) in ascending order, found by dividing a residue array
+    // by the primes up to sqrt(high). Entry ii belongs to low + ii and is empty for 0 and 1
+    [[nodiscard]] std::vector<std::vector<uint64_t>> factor_range(uint64_t low, uint64_t high);
+
+    // floor(sqrt(value))
+    [[nodiscard]] uint64_t isqrt(uint64_t value);
+} // end namespace sieve
+
+#endif //SIEVE_H
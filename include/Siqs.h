@@ -0,0 +1,16 @@
+#ifndef SIQS_H
+#define SIQS_H
+
+#include "BigUint.h"
+#include <optional>
+
+namespace factor
+{
+    // Self initializing quadratic sieve for odd composites of roughly 20 to 100 digits that are not perfect powers.
+    // Polynomials (A x + B)^2 - n switch B by Gray code, the sieve runs on cache sized blocks with rounded logarithms,
+    // one large prime per relation is allowed and dependencies come from Gaussian elimination over GF(2).
+    // Threads sieve different A coefficients. Returns nullopt when no dependency splits the number
+    [[nodiscard]] std::optional<BigUint> siqs(const BigUint &number, std::size_t threads = 1);
+} // end namespace factor
+
+#endif //SIQS_H
@@ -0,0 +1,52 @@
+#ifndef SWEEP_CHECKPOINT_H
+#define SWEEP_CHECKPOINT_H
+
+#include "BigUint.h"
+#include "FactorJournal.h"
+#include "Factorizer.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Where a sweep over consecutive numbers stands. Every number below next is committed to the table file,
+// so a resumed sweep starts there without reading the table again
+struct SweepCheckpoint {
+    static constexpr int VERSION = 1;
+
+    // The composite whose ECM stage was cut short and the curves it finished at b1
+    struct Ecm {
+        BigUint number;
+        uint64_t b1 = 0;
+        std::size_t curves = 0;
+    };
+
+    BigUint next;
+    uint64_t remaining = 0;
+    uint64_t window = 0; // numbers per sieve window, zero when numbers are factored one at a time
+    std::optional<Ecm> ecm;
+
+    // nullopt when there is no checkpoint file
+    static [[nodiscard]] std::optional<SweepCheckpoint> load(const std::filesystem::path &path);
+    // Replaces the file in one rename of a synced temporary file, a crash leaves either the old or the new checkpoint
+    void save(const std::filesystem::path &path) const;
+
+    // Folds the journal of the interrupted sweep into the table file. Records from next on were journaled after the
+    // checkpoint was saved and are dropped, the resumed sweep factors them again
+    void fold_committed(const std::filesystem::path &journal_path, const std::filesystem::path &table_path) const;
+    // Resumes the saved ECM stage at its curve count. After every round of curves the journal is flushed and the
+    // checkpoint saved to path, the progress refers to this checkpoint and must not outlive it
+    [[nodiscard]] factor::EcmProgress ecm_progress(FactorJournal &journal, const std::filesystem::path &path);
+};
+
+// Cuts the text table back to its size before a fold that was cut short, whose journal is still there to be folded
+// again. Has to run before the table is read, the lines of the unfinished fold may end in a torn one
+void undo_interrupted_fold(const std::filesystem::path &journal_path, const std::filesystem::path &table_path);
+
+// Appends the journal records that keep accepts to the text table with one open and drops the journal. The size of the
+// table before the fold is kept next to the journal until the fold is done, see undo_interrupted_fold
+void fold_journal(const std::filesystem::path &journal_path, const std::filesystem::path &table_path,
+                  const std::function<bool(const BigUint &, const std::vector<BigUint> &)> &keep);
+
+#endif //SWEEP_CHECKPOINT_H
@@ -0,0 +1,87 @@
+#ifndef WORD_ARITHMETIC_H
+#define WORD_ARITHMETIC_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Modular arithmetic on native 64-bit words, the fast path for values that fit in a machine word
+namespace word
+{
+    // high 64 bits of lhs * rhs, the low ones are stored in low
+    inline uint64_t multiply_wide(const uint64_t lhs, const uint64_t rhs, uint64_t &low) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        uint64_t high;
+        low = _umul128(lhs, rhs, &high);
+        return high;
+#else
+        const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+        low = static_cast<uint64_t>(product);
+        return static_cast<uint64_t>(product >> 64);
+#endif
+    }
+
+    [[nodiscard]] uint64_t mul_mod(uint64_t lhs, uint64_t rhs, uint64_t mod);
+    [[nodiscard]] uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t mod);
+
+    // Deterministic Miller-Rabin, exact for every 64-bit input
+    [[nodiscard]] bool is_prime(uint64_t number);
+
+    // Jacobi symbol (a / n) for an odd n
+    [[nodiscard]] int jacobi(uint64_t a, uint64_t n);
+
+    // x with x^2 = a (mod p) for an odd prime p, Tonelli-Shanks, nullopt when a is not a quadratic residue
+    [[nodiscard]] std::optional<uint64_t> sqrt_mod(uint64_t a, uint64_t p);
+
+    // A non trivial factor of an odd composite, Pollard's rho with Brent's cycle detection
+    [[nodiscard]] uint64_t pollard_rho(uint64_t number);
+
+    // Prime factors in ascending order, repeated by multiplicity, empty for zero and one
+    [[nodiscard]] std::vector<uint64_t> factor(uint64_t number);
+
+    // Montgomery form modulo an odd word, values are kept in [0, mod)
+    class Montgomery {
+    public:
+        explicit Montgomery(uint64_t mod);
+
+        [[nodiscard]] uint64_t modulus() const { return mod_; }
+        [[nodiscard]] uint64_t one() const { return one_; }
+        [[nodiscard]] uint64_t to_montgomery(const uint64_t value) const { return multiply(value % mod_, rSquared_); }
+        [[nodiscard]] uint64_t from_montgomery(const uint64_t value) const { return reduce(0, value); }
+
+        [[nodiscard]] uint64_t multiply(const uint64_t lhs, const uint64_t rhs) const {
+            uint64_t low;
+            const uint64_t high = multiply_wide(lhs, rhs, low);
+            return reduce(high, low);
+        }
+
+        [[nodiscard]] uint64_t add(const uint64_t lhs, const uint64_t rhs) const {
+            const uint64_t complement = mod_ - rhs;
+            return lhs >= complement ? lhs - complement : lhs + rhs;
+        }
+
+        [[nodiscard]] uint64_t subtract(const uint64_t lhs, const uint64_t rhs) const {
+            return lhs >= rhs ? lhs - rhs : lhs + (mod_ - rhs);
+        }
+
+        [[nodiscard]] uint64_t pow(uint64_t base, uint64_t exponent) const;
+
+    private:
+        uint64_t mod_;
+        uint64_t inverse_; // mod^-1 modulo 2^64
+        uint64_t one_;
+        uint64_t rSquared_;
+
+        // (high 2^64 + low) / 2^64 modulo mod, requires high < mod
+        [[nodiscard]] uint64_t reduce(const uint64_t high, const uint64_t low) const {
+            uint64_t productLow;
+            const uint64_t productHigh = multiply_wide(low * inverse_, mod_, productLow);
+            return high >= productHigh ? high - productHigh : high - productHigh + mod_;
+        }
+    };
+} // end namespace word
+
+#endif //WORD_ARITHMETIC_H
@@ -0,0 +1,87 @@
+#include "BatchGcd.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace batch_gcd
+{
+    ProductTree build_product_tree(std::span<const BigUint> moduli) {
+        ProductTree tree;
+        tree.emplace_back(moduli.begin(), moduli.end());
+        while (tree.back().size() > 1) {
+            const auto &level = tree.back();
+            std::vector<BigUint> products;
+            products.reserve((level.size() + 1) / 2);
+            for (std::size_t ii = 0; ii + 1 < level.size(); ii += 2) {
+                products.emplace_back(level[ii] * level[ii + 1]);
+            }
+            if (level.size() % 2 == 1) {
+                products.emplace_back(level.back());
+            }
+            tree.emplace_back(std::move(products));
+        }
+
+        return tree;
+    }
+
+    std::vector<BigUint> shared_factors(std::span<const BigUint> moduli) {
+        if (moduli.empty()) {
+            return {};
+        }
+
+        for (const auto &modulus : moduli) {
+            if (modulus == BigUint::ZERO) {
+                throw std::runtime_error("moduli cannot be zero");
+            }
+        }
+
+        const ProductTree tree = build_product_tree(moduli);
+
+        // Remainder tree, every node holds the product of all moduli modulo the square of the node
+        std::vector<BigUint> remainders = tree.back();
+        for (std::size_t level = tree.size() - 1; level-- > 0;) {
+            const auto &nodes = tree[level];
+            std::vector<BigUint> next(nodes.size());
+            for (std::size_t ii = 0; ii < nodes.size(); ii++) {
+                next[ii] = remainders[ii / 2] % nodes[ii].square();
+            }
+            remainders = std::move(next);
+        }
+
+        // (product mod modulus^2) / modulus = (product / modulus) mod modulus
+        std::vector<BigUint> factors(moduli.size());
+        for (std::size_t ii = 0; ii < moduli.size(); ii++) {
+            factors[ii] = BigUint::gcd(remainders[ii] / moduli[ii], moduli[ii]);
+        }
+
+        return factors;
+    }
+
+    std::vector<BigUint> read_moduli_from_file(const std::filesystem::path &path) {
+        std::ifstream fin(path);
+        if (!fin) {
+            throw std::runtime_error("Could not open file " + path.string());
+        }
+
+        std::vector<BigUint> moduli;
+        std::string line;
+        std::size_t line_counter = 0;
+        while (std::getline(fin, line)) {
+            line_counter++;
+            if (line.empty()) {
+                continue;
+            }
+
+            try {
+                std::istringstream iss(line);
+                BigUint number;
+                iss >> number;
+                moduli.emplace_back(std::move(number));
+            } catch (const std::exception &e) {
+                throw std::runtime_error("Could not parse line " + std::to_string(line_counter) + ": " + e.what());
+            }
+        }
+
+        return moduli;
+    }
+} // end namespace batch_gcd
@@ -1,11 +1,19 @@
 #include "BigUint.h"
+#include "Montgomery.h"
+#include "WordArithmetic.h"
 #include <stdexcept>
-#include <complex>
 #include <cmath>
 #include <execution>
 #include <vector>
 #include <numbers>
 #include <ranges>
+#include <bit>
+#include <limits>
+#include <thread>
+#include <algorithm>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 const BigUint BigUint::ZERO = BigUint();
 const BigUint BigUint::ONE = BigUint(static_cast<DigitType>(1));
@@ -58,6 +66,47 @@ std::optional<BigUint::WideDigitType> BigUint::as_wide_digit() const {
     return std::nullopt;
 }
 
+std::optional<uint64_t> BigUint::as_native_word() const {
+    constexpr std::size_t wordDigits = sizeof(uint64_t) / sizeof(DigitType);
+    if (digits_.size() > wordDigits) {
+        return std::nullopt;
+    }
+
+    uint64_t value = 0;
+    for (std::size_t ii = digits_.size(); ii-- > 0;) {
+        value = (value << std::numeric_limits<DigitType>::digits) | digits_[ii];
+    }
+    return value;
+}
+
+BigUint BigUint::from_native_word(uint64_t value) {
+    BigUint result;
+    result.digits_.clear();
+    do {
+        result.digits_.push_back(static_cast<DigitType>(value));
+        value >>= std::numeric_limits<DigitType>::digits;
+    } while (value != 0);
+    return result;
+}
+
+namespace {
+    // high 2^64 + low, the result of a native word multiplication
+    BigUint from_native_words(uint64_t high, uint64_t low) {
+        constexpr std::size_t wordDigits = sizeof(uint64_t) / sizeof(BigUint::DigitType);
+        BigUint::Digits digits(2 * wordDigits);
+        for (std::size_t ii = 0; ii < wordDigits; ii++) {
+            digits[ii] = static_cast<BigUint::DigitType>(low);
+            digits[ii + wordDigits] = static_cast<BigUint::DigitType>(high);
+            low >>= std::numeric_limits<BigUint::DigitType>::digits;
+            high >>= std::numeric_limits<BigUint::DigitType>::digits;
+        }
+
+        BigUint result;
+        result.set_digits(digits);
+        return result;
+    }
+}
+
 std::optional<BigUint::ByteType> BigUint::as_byte_digit() const {
     if (digits_.size() > 1) {
         return std::nullopt;
@@ -158,6 +207,101 @@ BigUint BigUint::shift_left(const size_t shiftPositions) const {
     return result;
 }
 
+void BigUint::shift_me_right(const size_t shiftPositions) {
+    if (shiftPositions == 0) {
+        return;
+    }
+
+    if (shiftPositions >= digits_.size()) {
+        *this = BigUint::ZERO;
+        return;
+    }
+
+    using diff_t = Digits::difference_type;
+    digits_.erase(digits_.begin(), digits_.begin() + static_cast<diff_t>(shiftPositions));
+}
+
+BigUint BigUint::shift_right(const size_t shiftPositions) const {
+    BigUint result = *this;
+    result.shift_me_right(shiftPositions);
+    return result;
+}
+
+void BigUint::shift_me_left_bits(const size_t shiftBits) {
+    constexpr std::size_t digitBits = std::numeric_limits<DigitType>::digits;
+    if (*this == BigUint::ZERO) {
+        return;
+    }
+
+    shift_me_left(shiftBits / digitBits);
+    const auto bits = static_cast<unsigned>(shiftBits % digitBits);
+    if (bits == 0) {
+        return;
+    }
+
+    DigitType carry = 0;
+    for (auto &digit : digits_) {
+        const WideDigitType shifted = static_cast<WideDigitType>(digit) << bits;
+        digit = static_cast<DigitType>(shifted | carry);
+        carry = static_cast<DigitType>(shifted >> digitBits);
+    }
+
+    if (carry != 0) {
+        digits_.push_back(carry);
+    }
+}
+
+BigUint BigUint::shift_left_bits(const size_t shiftBits) const {
+    BigUint result = *this;
+    result.shift_me_left_bits(shiftBits);
+    return result;
+}
+
+void BigUint::shift_me_right_bits(const size_t shiftBits) {
+    constexpr std::size_t digitBits = std::numeric_limits<DigitType>::digits;
+    shift_me_right(shiftBits / digitBits);
+    const auto bits = static_cast<unsigned>(shiftBits % digitBits);
+    if (bits == 0) {
+        return;
+    }
+
+    const std::size_t size = digits_.size();
+    for (std::size_t ii = 0; ii < size; ii++) {
+        const WideDigitType high = ii + 1 < size ? digits_[ii + 1] : 0;
+        const WideDigitType pair = (high << digitBits) | digits_[ii];
+        digits_[ii] = static_cast<DigitType>(pair >> bits);
+    }
+
+    remove_leading_zeros();
+}
+
+BigUint BigUint::shift_right_bits(const size_t shiftBits) const {
+    BigUint result = *this;
+    result.shift_me_right_bits(shiftBits);
+    return result;
+}
+
+std::size_t BigUint::bit_length() const {
+    constexpr std::size_t digitBits = std::numeric_limits<DigitType>::digits;
+    if (*this == BigUint::ZERO) {
+        return 0;
+    }
+
+    return (digits_.size() - 1) * digitBits + static_cast<std::size_t>(std::bit_width(digits_.back()));
+}
+
+// returns zero for zero
+std::size_t BigUint::count_trailing_zeros() const {
+    constexpr std::size_t digitBits = std::numeric_limits<DigitType>::digits;
+    for (std::size_t ii = 0; ii < digits_.size(); ii++) {
+        if (digits_[ii] != 0) {
+            return ii * digitBits + static_cast<std::size_t>(std::countr_zero(digits_[ii]));
+        }
+    }
+
+    return 0;
+}
+
 void BigUint::me_plus_one() {
     if (*this == ZERO) {
         *this = ONE;
@@ -430,7 +574,7 @@ void BigUint::subtract_me(const BigUint &rhs) {
     std::size_t currentDigitPosition = 0;
     for (; currentDigitPosition < rhs.digits_.size(); currentDigitPosition++) {
         WideDigit currentDigit = digits_[currentDigitPosition];
-        if (const WideDigit otherCurrentDigit = rhs.digits_[currentDigitPosition] + carry; currentDigit > otherCurrentDigit) {
+        if (const WideDigit otherCurrentDigit = rhs.digits_[currentDigitPosition] + carry; currentDigit >= otherCurrentDigit) {
             result.push_back(static_cast<DigitType>(currentDigit - otherCurrentDigit));
             carry = 0;
         } else {
@@ -494,7 +638,7 @@ void BigUint::multiply_me_by(DigitType digit) {
 
     DigitType carry = 0;
     for (auto &thisDigit: digits_) {
-        const WideDigitType product = thisDigit * digit + carry;
+        const WideDigitType product = static_cast<WideDigitType>(thisDigit) * digit + carry;
         DigitType calculatedDigit = 0;
         if (product >= BASE) {
             WideDigitType aux = product / BASE;
@@ -529,6 +673,25 @@ BigUint BigUint::operator*(const DigitType digit) const {
 }
 
 void BigUint::multiply_me_by(const BigUint &rhs) {
+    const auto lhsWord = as_native_word();
+    const auto rhsWord = rhs.as_native_word();
+    if (lhsWord && rhsWord) {
+        uint64_t low;
+        const uint64_t high = word::multiply_wide(*lhsWord, *rhsWord, low);
+        *this = from_native_words(high, low);
+        return;
+    }
+
+    if (std::min(digits_.size(), rhs.digits_.size()) >= FFT_MIN_DIGITS) {
+        *this = multiply_me_fft(rhs);
+        return;
+    }
+
+    if (std::min(digits_.size(), rhs.digits_.size()) >= KARATSUBA_MIN_DIGITS) {
+        *this = multiply_me_karatsuba(rhs);
+        return;
+    }
+
     *this = multiply_me_naive(rhs);
 }
 
@@ -575,6 +738,20 @@ void BigUint::square_me() {
         return result;
     }
 
+    if (const auto value = as_native_word()) {
+        uint64_t low;
+        const uint64_t high = word::multiply_wide(*value, *value, low);
+        return from_native_words(high, low);
+    }
+
+    if (digits_.size() >= FFT_MIN_DIGITS) {
+        return multiply_me_fft(*this);
+    }
+
+    if (digits_.size() >= KARATSUBA_MIN_DIGITS) {
+        return multiply_me_karatsuba(*this);
+    }
+
     const auto resultDigits = opt_inner_square(digits_);
     BigUint result;
     result.digits_ = resultDigits;
@@ -648,6 +825,111 @@ void BigUint::pow_me_by(const BigUint &power) {
     return u;
 }
 
+namespace {
+    // The root from the leading 53 bits in double precision. The whole multiples of k in the dropped bits are split off
+    // first, so the relative error stays near 2^-46 for numbers of any size
+    BigUint estimate_root(const BigUint &number, const uint32_t k) {
+        const std::size_t bits = number.bit_length();
+        const std::size_t dropped = bits > 53 ? bits - 53 : 0;
+        const double leading = static_cast<double>(*number.shift_right_bits(dropped).as_native_word());
+        const double logRoot = (std::log2(leading) + static_cast<double>(dropped % k)) / k;
+        const double whole = std::floor(logRoot);
+        // 2^(fraction) scaled to 52 bits, shifted into place
+        const auto mantissa = static_cast<uint64_t>(std::ldexp(std::exp2(logRoot - whole), 52));
+        const std::size_t exponent = dropped / k + static_cast<std::size_t>(whole);
+        const BigUint root = BigUint::from_native_word(mantissa);
+        return exponent >= 52 ? root.shift_left_bits(exponent - 52) : root.shift_right_bits(52 - exponent);
+    }
+}
+
+BigUint BigUint::isqrt() const {
+    return iroot(2);
+}
+
+BigUint BigUint::iroot(const uint32_t k) const {
+    if (k == 0) {
+        throw std::runtime_error("zeroth root");
+    }
+    if (k == 1 || *this <= BigUint::ONE) {
+        return *this;
+    }
+    // 2^k is above the number
+    if (k >= bit_length()) {
+        return BigUint::ONE;
+    }
+
+    const BigUint degree(k);
+    const BigUint lower(k - 1);
+    const auto step = [&](const BigUint &root) {
+        const BigUint power = k == 2 ? root : root.pow_by(lower);
+        return (root * lower + *this / power) / degree;
+    };
+
+    // Newton's iteration decreases monotonically from any start above the root, but from below it first overshoots
+    // by a factor that grows exponentially with k, so the estimate is raised just past its error bound
+    BigUint root = estimate_root(*this, k);
+    root = root + root.shift_right_bits(40) + BigUint::ONE;
+    while (true) {
+        BigUint next = step(root);
+        if (next >= root) {
+            return root;
+        }
+        root = std::move(next);
+    }
+}
+
+namespace {
+    // Primes q = 1 (mod k) tried before a k-th root, each rejects a random residue with probability about 1 - 1 / k
+    constexpr int POWER_RESIDUE_TESTS = 4;
+
+    // false when number is certainly no k-th power for a prime k, from the k-th power residues mod small primes
+    bool may_be_power(const BigUint &number, const uint32_t k) {
+        int tests = 0;
+        for (uint64_t q = 2 * uint64_t{k} + 1; q <= std::numeric_limits<BigUint::DigitType>::max() && tests < POWER_RESIDUE_TESTS; q += 2 * k) {
+            if (!word::is_prime(q)) {
+                continue;
+            }
+            tests++;
+            const uint64_t residue = number % static_cast<BigUint::DigitType>(q);
+            // the nonzero k-th powers are the residues of order dividing (q - 1) / k
+            if (residue != 0 && word::pow_mod(residue, (q - 1) / k, q) != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+std::optional<std::pair<BigUint, uint32_t>> BigUint::is_perfect_power() const {
+    if (*this <= BigUint::ONE) {
+        return std::nullopt;
+    }
+
+    // the exponent divides the power of two in the number
+    const std::size_t twos = count_trailing_zeros();
+    BigUint base = *this;
+    uint32_t exponent = 1;
+    // A prime k rejected for the number is never a factor of the exponent of any of its roots either,
+    // so the primes are tried once each in ascending order, and a k that fits is tried again on the root
+    for (uint32_t k = 2; k < base.bit_length(); k += k == 2 ? 1 : 2) {
+        if ((k > 3 && !word::is_prime(k)) || (twos != 0 && twos % (uint64_t{exponent} * k) != 0)) {
+            continue;
+        }
+        while (k < base.bit_length() && may_be_power(base, k)) {
+            BigUint root = base.iroot(k);
+            if (root.pow_by(BigUint(k)) != base) {
+                break;
+            }
+            base = std::move(root);
+            exponent *= k;
+        }
+    }
+    if (exponent == 1) {
+        return std::nullopt;
+    }
+    return std::pair{std::move(base), exponent};
+}
+
 // returns the remainder
 BigUint::DigitType BigUint::divide_me_by(const DigitType divisor) {
     if (divisor == 0) {
@@ -722,6 +1004,14 @@ BigUint::DigitType BigUint::operator%(DigitType digit) const {
     return remainder;
 }
 
+uint64_t BigUint::remainder_by_word(const uint64_t divisor) const {
+    uint64_t remainder = 0;
+    for (std::size_t ii = digits_.size(); ii-- > 0;) {
+        remainder = ((remainder << std::numeric_limits<DigitType>::digits) | digits_[ii]) % divisor;
+    }
+    return remainder;
+}
+
 // returns the remainder
 BigUint BigUint::divide_me_by(const BigUint &rhs) {
     const auto [quotient, remainder] = divide_by(*this, rhs);
@@ -842,6 +1132,10 @@ BigUint BigUint::mod_mul(const BigUint& lhs, const BigUint& rhs, const BigUint&
 
     const auto lhsMod = lhs % mod;
     const auto rhsMod = rhs % mod;
+    if (const auto modWord = mod.as_native_word()) {
+        return from_native_word(word::mul_mod(*lhsMod.as_native_word(), *rhsMod.as_native_word(), *modWord));
+    }
+
     const auto result = lhsMod * rhsMod;
     return result % mod;
 }
@@ -869,17 +1163,157 @@ BigUint BigUint::modPow(const BigUint& exponent, const BigUint& mod) const {
 */
 
 BigUint BigUint::gcd(BigUint a, BigUint b) {
-    while (b != BigUint::ZERO) {
-        BigUint r = a % b;
-        a = b;
-        b = std::move(r);
+    if (std::max(a.digits_.size(), b.digits_.size()) <= BINARY_GCD_MAX_DIGITS) {
+        return binary_gcd(std::move(a), std::move(b));
     }
 
-    return a;
+    if (std::min(a.digits_.size(), b.digits_.size()) >= HALF_GCD_MIN_DIGITS) {
+        return subquadratic_gcd(std::move(a), std::move(b));
+    }
+
+    return lehmer_gcd(std::move(a), std::move(b));
 }
 
 BigUint BigUint::lcm(const BigUint &a, const BigUint &b) {
-    return a * b / gcd(a, b);
+    if (a == BigUint::ZERO || b == BigUint::ZERO) {
+        return BigUint::ZERO;
+    }
+
+    return a / gcd(a, b) * b;
+}
+
+namespace {
+    constexpr std::size_t NATIVE_WORD_DIGITS = sizeof(uint64_t) / sizeof(BigUint::DigitType);
+
+    // Stein's algorithm, both operands odd and non zero
+    uint64_t odd_binary_gcd(uint64_t a, uint64_t b) {
+        while (a != b) {
+            if (a > b) {
+                std::swap(a, b);
+            }
+            b -= a;
+            b >>= std::countr_zero(b);
+        }
+        return a;
+    }
+
+    // Reads 64 bits of the number starting at bit position offset
+    uint64_t read_bits(const BigUint::Digits &digits, const std::size_t offset) {
+        constexpr std::size_t digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+        const std::size_t first = offset / digitBits;
+        uint64_t value = 0;
+        for (std::size_t ii = first + NATIVE_WORD_DIGITS; ii-- > first;) {
+            value <<= digitBits;
+            value |= ii < digits.size() ? digits[ii] : 0;
+        }
+        return value >> (offset % digitBits);
+    }
+
+    // (a, b) <- (A*a + B*b, C*a + D*b) in a single pass over the digits. Results are known to be non negative.
+    void apply_cofactors(BigUint::Digits &a, BigUint::Digits &b,
+                         const int64_t A, const int64_t B, const int64_t C, const int64_t D) {
+        constexpr int64_t digitMask = BigUint::BASE - 1;
+        constexpr int digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+        b.resize(a.size(), 0);
+        int64_t carryA = 0;
+        int64_t carryB = 0;
+        for (std::size_t ii = 0; ii < a.size(); ii++) {
+            const int64_t aDigit = a[ii];
+            const int64_t bDigit = b[ii];
+            const int64_t newA = A * aDigit + B * bDigit + carryA;
+            const int64_t newB = C * aDigit + D * bDigit + carryB;
+            a[ii] = static_cast<BigUint::DigitType>(newA & digitMask);
+            b[ii] = static_cast<BigUint::DigitType>(newB & digitMask);
+            carryA = newA >> digitBits;
+            carryB = newB >> digitBits;
+        }
+
+        while (a.size() > 1 && a.back() == 0) a.pop_back();
+        while (b.size() > 1 && b.back() == 0) b.pop_back();
+    }
+}
+
+BigUint BigUint::binary_gcd(BigUint a, BigUint b) {
+    if (a == BigUint::ZERO) {
+        return b;
+    }
+
+    if (b == BigUint::ZERO) {
+        return a;
+    }
+
+    const auto aZeros = a.count_trailing_zeros();
+    const auto bZeros = b.count_trailing_zeros();
+    const auto commonZeros = std::min(aZeros, bZeros);
+    a.shift_me_right_bits(aZeros);
+    b.shift_me_right_bits(bZeros);
+
+    // Both odd from here on: subtract the smaller and strip the zeros the subtraction creates
+    while (true) {
+        const auto aWord = a.as_native_word();
+        const auto bWord = b.as_native_word();
+        if (aWord && bWord) {
+            a = from_native_word(odd_binary_gcd(*aWord, *bWord));
+            break;
+        }
+
+        if (a > b) {
+            std::swap(a, b);
+        }
+
+        subtract_in_place(b.digits_, a.digits_);
+        if (b == BigUint::ZERO) {
+            break;
+        }
+        b.shift_me_right_bits(b.count_trailing_zeros());
+    }
+
+    a.shift_me_left_bits(commonZeros);
+    return a;
+}
+
+// Knuth's algorithm L using the leading double digit of the operands
+BigUint BigUint::lehmer_gcd(BigUint a, BigUint b) {
+    if (a < b) {
+        std::swap(a, b);
+    }
+
+    while (b.digits_.size() > NATIVE_WORD_DIGITS) {
+        constexpr std::size_t leadingBits = 2 * std::numeric_limits<DigitType>::digits;
+        const std::size_t shift = a.bit_length() - leadingBits;
+        auto x = static_cast<int64_t>(read_bits(a.digits_, shift) & 0xFFFF'FFFF);
+        auto y = static_cast<int64_t>(read_bits(b.digits_, shift) & 0xFFFF'FFFF);
+
+        int64_t A = 1, B = 0, C = 0, D = 1;
+        while (y + C != 0 && y + D != 0) {
+            const int64_t q = (x + A) / (y + C);
+            if (q != (x + B) / (y + D)) {
+                break;
+            }
+
+            int64_t t = A - q * C;
+            A = C;
+            C = t;
+            t = B - q * D;
+            B = D;
+            D = t;
+            t = x - q * y;
+            x = y;
+            y = t;
+        }
+
+        if (B == 0) {
+            // The leading digits do not determine a single quotient, take a full division step
+            BigUint remainder = a % b;
+            a = std::move(b);
+            b = std::move(remainder);
+        }
+        else {
+            apply_cofactors(a.digits_, b.digits_, A, B, C, D);
+        }
+    }
+
+    return binary_gcd(std::move(a), std::move(b));
 }
 
 void BigUint::remove_leading_zeros() {
@@ -901,23 +1335,48 @@ BigUint BigUint::multiply_me_naive(const BigUint& other) const {
         return other.multiply_by(digits_.front());
     }
 
-    std::vector<BigUint> partialMultiplications(other.digits_.size());
-    std::size_t shiftCounter = 0;
-    for (const auto otherCurrentDigit : other.digits_) {
-        BigUint currentMultiplication = this->multiply_by(otherCurrentDigit);
-        currentMultiplication.shift_me_left(shiftCounter);
-        partialMultiplications[shiftCounter] = currentMultiplication;
-        shiftCounter++;
-    }
+    // Schoolbook multiplication, digit by digit products never overflow the wide digit
+    Digits resultDigits(digits_.size() + other.digits_.size(), 0);
+    for (std::size_t ii = 0; ii < other.digits_.size(); ii++) {
+        const WideDigitType otherDigit = other.digits_[ii];
+        if (otherDigit == 0) {
+            continue;
+        }
 
-    BigUint result;
-    for (const auto &multiplication : partialMultiplications) {
-        result += multiplication;
+        WideDigitType carry = 0;
+        for (std::size_t jj = 0; jj < digits_.size(); jj++) {
+            const WideDigitType partial = resultDigits[ii + jj] + otherDigit * digits_[jj] + carry;
+            resultDigits[ii + jj] = static_cast<DigitType>(partial);
+            carry = partial >> std::numeric_limits<DigitType>::digits;
+        }
+        resultDigits[ii + digits_.size()] = static_cast<DigitType>(carry);
     }
 
+    BigUint result;
+    result.digits_ = std::move(resultDigits);
+    result.remove_leading_zeros();
     return result;
 }
 
+namespace {
+    BigUint low_bits(const BigUint &value, const std::size_t bits) {
+        constexpr std::size_t digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+        const auto &digits = value.get_digits();
+        if (bits >= digits.size() * digitBits) {
+            return value;
+        }
+
+        BigUint::Digits low(digits.begin(), digits.begin() + static_cast<std::ptrdiff_t>((bits + digitBits - 1) / digitBits));
+        if (bits % digitBits != 0) {
+            low.back() = static_cast<BigUint::DigitType>(low.back() & ((1U << (bits % digitBits)) - 1));
+        }
+
+        BigUint result;
+        result.set_digits(low);
+        return result;
+    }
+}
+
 std::pair<BigUint, BigUint> BigUint::divide_by(const BigUint &dividend, const BigUint &divisor) {
     if (divisor == BigUint::ZERO) {
         throw std::runtime_error("Division by zero is not allowed.");
@@ -935,6 +1394,11 @@ std::pair<BigUint, BigUint> BigUint::divide_by(const BigUint &dividend, const Bi
         return {BigUint::ZERO, dividend};
     }
 
+    if (const auto dividendWord = dividend.as_native_word()) {
+        const uint64_t divisorWord = *divisor.as_native_word();
+        return {from_native_word(*dividendWord / divisorWord), from_native_word(*dividendWord % divisorWord)};
+    }
+
     if (divisor.digits_.size() == 1) {
         const auto digit = divisor.digits_.front();
         const auto [quotient, remainder] = dividend.divide_by(digit);
@@ -942,137 +1406,237 @@ std::pair<BigUint, BigUint> BigUint::divide_by(const BigUint &dividend, const Bi
         return {quotient, remainderAsUint};
     }
 
-    BigUint quotient, remainder;
-    remainder.digits_.resize(dividend.digits_.size());
-
-    // Process digits from most to least significant
-    for (int i = static_cast<int>(dividend.digits_.size()) - 1; i >= 0; --i) {
-        remainder.digits_.insert(remainder.digits_.begin(), dividend.digits_[i]);  // Shift remainder
-        remainder.remove_leading_zeros();
-
-        DigitType q = 0;
-        if (remainder >= divisor) {
-            // Use binary search to find the largest `q` such that `q * divisor <= remainder`
-            WideDigitType low = 0, high = BASE - 1;
-            while (low <= high) {
-                const WideDigitType lowPlusHigh = (low + high);
-                const auto mid = static_cast<DigitType>(lowPlusHigh / 2);
-                const BigUint test = divisor * BigUint(mid);
-
-                if (test <= remainder) {
-                    q = mid;
-                    low = mid + 1;
-                } else {
-                    high = mid - 1;
-                }
+    if (divisor.digits_.size() >= NEWTON_DIVISION_MIN_DIGITS && dividend.digits_.size() - divisor.digits_.size() >= 2 * NEWTON_DIVISION_MIN_DIGITS) {
+        return newton_divide_by(dividend, divisor);
+    }
+
+    // Knuth, The Art of Computer Programming vol. 2, algorithm D
+    constexpr int digitBits = std::numeric_limits<DigitType>::digits;
+    constexpr int64_t digitMask = BASE - 1;
+    const auto shift = static_cast<std::size_t>(std::countl_zero(divisor.digits_.back()));
+    Digits u = dividend.shift_left_bits(shift).digits_;
+    const Digits v = divisor.shift_left_bits(shift).digits_;
+    const std::size_t n = v.size();
+    if (u.size() == dividend.digits_.size()) {
+        u.push_back(0);
+    }
+    const std::size_t m = u.size() - n - 1;
+
+    const uint64_t vTop = v[n - 1];
+    const uint64_t vNext = v[n - 2];
+    Digits q(m + 1, 0);
+    for (std::size_t jj = m + 1; jj-- > 0;) {
+        const uint64_t numerator = (static_cast<uint64_t>(u[jj + n]) << digitBits) | u[jj + n - 1];
+        uint64_t qHat = numerator / vTop;
+        uint64_t rHat = numerator % vTop;
+        while (qHat >= BASE || qHat * vNext > ((rHat << digitBits) | u[jj + n - 2])) {
+            qHat--;
+            rHat += vTop;
+            if (rHat >= BASE) {
+                break;
             }
-
-            remainder = remainder - (divisor * BigUint(q));
         }
 
-        quotient.digits_.insert(quotient.digits_.begin(), q);
+        // u[jj .. jj + n] -= qHat * v
+        int64_t borrow = 0;
+        int64_t t = 0;
+        for (std::size_t ii = 0; ii < n; ii++) {
+            const uint64_t product = qHat * v[ii];
+            t = static_cast<int64_t>(u[ii + jj]) - borrow - static_cast<int64_t>(product & digitMask);
+            u[ii + jj] = static_cast<DigitType>(t & digitMask);
+            borrow = static_cast<int64_t>(product >> digitBits) - (t >> digitBits);
+        }
+        t = static_cast<int64_t>(u[jj + n]) - borrow;
+        u[jj + n] = static_cast<DigitType>(t & digitMask);
+
+        q[jj] = static_cast<DigitType>(qHat);
+        if (t < 0) {
+            // qHat was one too large, add the divisor back
+            q[jj]--;
+            WideDigitType carry = 0;
+            for (std::size_t ii = 0; ii < n; ii++) {
+                const WideDigitType sum = static_cast<WideDigitType>(u[ii + jj]) + v[ii] + carry;
+                u[ii + jj] = static_cast<DigitType>(sum);
+                carry = sum >> digitBits;
+            }
+            u[jj + n] = static_cast<DigitType>(u[jj + n] + carry);
+        }
     }
 
+    BigUint quotient, remainder;
+    quotient.digits_ = std::move(q);
     quotient.remove_leading_zeros();
+    u.resize(n);
+    remainder.digits_ = std::move(u);
     remainder.remove_leading_zeros();
+    remainder.shift_me_right_bits(shift);
     return {quotient, remainder};
 }
 
-using Complex = std::complex<double>;
-const double PI = acos(-1);
+namespace {
+    // Number theoretic transform modulo the prime 2^64 - 2^32 + 1. Its 2^32-th roots of unity and
+    // the bound (BASE - 1)^2 * length < p make a single prime exact for up to 2^32 digits.
+    constexpr uint64_t NTT_PRIME = 0xFFFF'FFFF'0000'0001ULL;
+    constexpr uint64_t NTT_EPSILON = 0xFFFF'FFFFULL; // 2^64 mod p
+    constexpr uint64_t NTT_GENERATOR = 7;
 
-// NOLINTNEXTLINE(misc-no-recursion)
-void fft(std::vector<std::complex<double>>& a, bool invert) {
-    size_t n = a.size();
-    if (n == 1) return;
+    // The reductions below use masks instead of branches, the transform feeds them random data
+    uint64_t mask_if(const bool condition, const uint64_t value) {
+        return value & (0 - static_cast<uint64_t>(condition));
+    }
+
+    uint64_t ntt_sub(const uint64_t lhs, const uint64_t rhs) {
+        return lhs - rhs + mask_if(lhs < rhs, NTT_PRIME);
+    }
+
+    uint64_t ntt_add(const uint64_t lhs, const uint64_t rhs) {
+        return ntt_sub(lhs, NTT_PRIME - rhs);
+    }
 
-    const double angle = 2 * std::numbers::pi / static_cast<double>(n) * (invert ? -1 : 1);
-    const std::complex<double> wn(cos(angle), sin(angle));
-    std::complex<double> w(1);
+    uint64_t ntt_mul(const uint64_t lhs, const uint64_t rhs) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        uint64_t high;
+        const uint64_t low = _umul128(lhs, rhs, &high);
+#else
+        const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+        const auto low = static_cast<uint64_t>(product);
+        const auto high = static_cast<uint64_t>(product >> 64);
+#endif
+        // high * 2^64 = highHigh * 2^96 + highLow * 2^64 = -highHigh + highLow * (2^32 - 1)
+        const uint64_t highHigh = high >> 32;
+        const uint64_t highLow = high & NTT_EPSILON;
+        uint64_t result = low - highHigh - mask_if(low < highHigh, NTT_EPSILON);
+        const uint64_t term = highLow * NTT_EPSILON;
+        result += term;
+        result += mask_if(result < term, NTT_EPSILON);
+        return result - mask_if(result >= NTT_PRIME, NTT_PRIME);
+    }
 
-    std::vector<std::complex<double>> a0(n / 2), a1(n / 2);
-    for (size_t i = 0; i < n / 2; ++i) {
-        a0[i] = a[i * 2];
-        a1[i] = a[i * 2 + 1];
+    uint64_t ntt_pow(uint64_t base, uint64_t exponent) {
+        uint64_t result = 1;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result = ntt_mul(result, base);
+            }
+            base = ntt_mul(base, base);
+            exponent >>= 1;
+        }
+        return result;
     }
 
-    fft(a0, invert);
-    fft(a1, invert);
+    // In place iterative transform, values.size() must be a power of two
+    void ntt(std::vector<uint64_t> &values, const bool invert) {
+        const std::size_t n = values.size();
+        for (std::size_t ii = 1, jj = 0; ii < n; ii++) {
+            std::size_t bit = n >> 1;
+            for (; jj & bit; bit >>= 1) {
+                jj ^= bit;
+            }
+            jj ^= bit;
+            if (ii < jj) {
+                std::swap(values[ii], values[jj]);
+            }
+        }
+
+        std::vector<uint64_t> twiddles(n / 2);
+        for (std::size_t length = 2; length <= n; length <<= 1) {
+            uint64_t root = ntt_pow(NTT_GENERATOR, (NTT_PRIME - 1) / length);
+            if (invert) {
+                root = ntt_pow(root, NTT_PRIME - 2);
+            }
+
+            const std::size_t half = length / 2;
+            twiddles[0] = 1;
+            for (std::size_t ii = 1; ii < half; ii++) {
+                twiddles[ii] = ntt_mul(twiddles[ii - 1], root);
+            }
+
+            for (std::size_t start = 0; start < n; start += length) {
+                for (std::size_t ii = 0; ii < half; ii++) {
+                    const uint64_t even = values[start + ii];
+                    const uint64_t odd = ntt_mul(values[start + ii + half], twiddles[ii]);
+                    values[start + ii] = ntt_add(even, odd);
+                    values[start + ii + half] = ntt_sub(even, odd);
+                }
+            }
+        }
 
-    for (size_t i = 0; i < n / 2; ++i) {
-        std::complex<double> temp = w * a1[i];
-        a[i] = a0[i] + temp;
-        a[i + n / 2] = a0[i] - temp;
         if (invert) {
-            a[i] /= 2;
-            a[i + n / 2] /= 2;
+            const uint64_t inverseSize = ntt_pow(n, NTT_PRIME - 2);
+            for (auto &value : values) {
+                value = ntt_mul(value, inverseSize);
+            }
         }
-        w *= wn;
     }
 }
 
 BigUint BigUint::multiply_me_fft(const BigUint& b) const {
-    // Convert BigUint digits to complex vectors
-    std::vector<std::complex<double>> fa(this->digits_.begin(), this->digits_.end());
-    std::vector<std::complex<double>> fb(b.digits_.begin(), b.digits_.end());
-
     // Find the next power of 2 greater than the size of both numbers
     size_t n = 1;
     while (n < this->digits_.size() + b.digits_.size()) n <<= 1;
-    fa.resize(n);
-    fb.resize(n);
 
-    // Perform FFT
-    fft(fa, false);
-    fft(fb, false);
+    std::vector<uint64_t> fa(n, 0);
+    std::vector<uint64_t> fb(n, 0);
+    std::ranges::copy(this->digits_, fa.begin());
+    std::ranges::copy(b.digits_, fb.begin());
+
+    ntt(fa, false);
+    ntt(fb, false);
 
     // Point-wise multiplication
     for (size_t i = 0; i < n; ++i) {
-        fa[i] *= fb[i];
+        fa[i] = ntt_mul(fa[i], fb[i]);
     }
 
-    // Inverse FFT
-    fft(fa, true);
+    ntt(fa, true);
 
-    // Convert the result back to BigUint
+    // Convert the result back to BigUint, coefficients are below 2^64 so the carry fits in 64 bits too
     std::vector<BigUint::DigitType> result(n);
-    WideDigitType carry = 0;
+    uint64_t carry = 0;
     for (size_t ii = 0; ii < n; ++ii) {
-        WideDigitType sum = static_cast<WideDigitType>(round(fa[ii].real())) + carry;
-        result[ii] = static_cast<DigitType>(sum % BigUint::BASE);
-        carry = sum / BigUint::BASE;
-    }
-
-    // Remove leading zeros
-    while (result.size() > 1 && result.back() == 0) {
-        result.pop_back();
+        const uint64_t low = (fa[ii] & (BASE - 1)) + (carry & (BASE - 1));
+        result[ii] = static_cast<DigitType>(low);
+        carry = (fa[ii] >> std::numeric_limits<DigitType>::digits) + (carry >> std::numeric_limits<DigitType>::digits) + (low >> std::numeric_limits<DigitType>::digits);
     }
 
     BigUint res;
-    res.digits_ = result;
+    res.digits_ = std::move(result);
+    res.remove_leading_zeros();
     return res;
 }
 
+// returns low and high parts
 std::pair<BigUint, BigUint> BigUint::split(std::size_t pos) const {
     if (pos >= digits_.size()) {
-        return {BigUint(0), *this};
+        return {*this, BigUint::ZERO};
     }
 
     using diff_t = std::vector<int>::difference_type;
     BigUint low, high;
     low.digits_.assign(digits_.begin(), digits_.begin() + static_cast<diff_t>(pos));
     high.digits_.assign(digits_.begin() + static_cast<diff_t>(pos), digits_.end());
+    low.remove_leading_zeros();
     high.remove_leading_zeros();
     return {low, high};
 }
 
 // NOLINTNEXTLINE(misc-no-recursion)
 BigUint BigUint::multiply_me_karatsuba(const BigUint& other) const {
-    if (constexpr std::size_t minimumNumberOfDigits = 2; digits_.size() < minimumNumberOfDigits || other.digits_.size() < minimumNumberOfDigits) {
+    const std::size_t smallerSize = std::min(digits_.size(), other.digits_.size());
+    if (smallerSize < KARATSUBA_MIN_DIGITS) {
         return multiply_me_naive(other);
     }
 
-    const size_t middle = digits_.size() / 2;
+    const size_t middle = std::max(digits_.size(), other.digits_.size()) / 2;
+    if (smallerSize <= middle) {
+        // Unbalanced operands: split only the larger one
+        const bool thisIsLarger = digits_.size() > other.digits_.size();
+        const BigUint &larger = thisIsLarger ? *this : other;
+        const BigUint &smaller = thisIsLarger ? other : *this;
+        const auto [low, high] = larger.split(middle);
+        return high.multiply_me_karatsuba(smaller).shift_left(middle) + low.multiply_me_karatsuba(smaller);
+    }
+
     const auto [low1, high1] = split(middle);
     const auto [low2, high2] = other.split(middle);
 
@@ -1131,6 +1695,765 @@ BigUint BigUint::multiply_me_karatsuba(const BigUint& other) const {
     return resultDigits;
 }
 
+// floor(2^(2n) / divisor) where n is the bit length of the divisor
+BigUint BigUint::reciprocal(const BigUint &divisor) {
+    const std::size_t bits = divisor.bit_length();
+    const BigUint power = BigUint::ONE.shift_left_bits(2 * bits);
+    if (divisor.digits_.size() < NEWTON_DIVISION_MIN_DIGITS) {
+        return divide_by(power, divisor).first;
+    }
+
+    // The reciprocal of the top half is correct to about half the bits, one Newton step doubles that
+    constexpr std::size_t guardBits = 32;
+    const std::size_t high = bits / 2 + guardBits;
+    const std::size_t shift = bits - high;
+    BigUint x = reciprocal(divisor.shift_right_bits(shift)).shift_left_bits(shift);
+
+    // x <- x + x (2^(2n) - divisor x) / 2^(2n)
+    const BigUint product = divisor * x;
+    if (product <= power) {
+        x += (x * (power - product)).shift_right_bits(2 * bits);
+    }
+    else {
+        x -= (x * (product - power)).shift_right_bits(2 * bits) + BigUint::ONE;
+    }
+
+    // x is now off by a few units at most
+    BigUint remainder = divisor * x;
+    while (remainder > power) {
+        remainder -= divisor;
+        x.me_minus_one();
+    }
+    remainder = power - remainder;
+    while (remainder >= divisor) {
+        remainder -= divisor;
+        x.me_plus_one();
+    }
+    return x;
+}
+
+// Divides blocks of n bits of the dividend by multiplying with the reciprocal of the n bit divisor
+std::pair<BigUint, BigUint> BigUint::newton_divide_by(const BigUint &dividend, const BigUint &divisor) {
+    const std::size_t bits = divisor.bit_length();
+    const BigUint inverse = reciprocal(divisor);
+    const std::size_t blocks = (dividend.bit_length() + bits - 1) / bits;
+
+    BigUint quotient;
+    BigUint remainder;
+    for (std::size_t block = blocks; block-- > 0;) {
+        // current < 2^(2n) since remainder < divisor
+        const BigUint current = remainder.shift_left_bits(bits) + low_bits(dividend.shift_right_bits(block * bits), bits);
+        BigUint q = (current * inverse).shift_right_bits(2 * bits);
+        remainder = current - q * divisor;
+        while (remainder >= divisor) {
+            remainder -= divisor;
+            q.me_plus_one();
+        }
+        quotient = quotient.shift_left_bits(bits) + q;
+    }
+    return {quotient, remainder};
+}
+
+namespace {
+    // (a, b) = M (alpha, beta) where M is a product of [[q, 1], [1, 0]] quotient matrices,
+    // so its entries are non negative and its determinant is -1 for an odd number of quotients.
+    struct QuotientMatrix {
+        BigUint m00 = BigUint::ONE;
+        BigUint m01 = BigUint::ZERO;
+        BigUint m10 = BigUint::ZERO;
+        BigUint m11 = BigUint::ONE;
+        bool odd = false;
+
+        [[nodiscard]] bool is_identity() const {
+            return m01 == BigUint::ZERO && m10 == BigUint::ZERO;
+        }
+
+        // M <- M [[q, 1], [1, 0]]
+        void push_quotient(const BigUint &q) {
+            BigUint next00 = m00 * q + m01;
+            BigUint next10 = m10 * q + m11;
+            m01 = std::move(m00);
+            m11 = std::move(m10);
+            m00 = std::move(next00);
+            m10 = std::move(next10);
+            odd = !odd;
+        }
+
+        // M <- M [[0, 1], [1, -q]]
+        void pop_quotient(const BigUint &q) {
+            BigUint previous01 = m00 - q * m01;
+            BigUint previous11 = m10 - q * m11;
+            m00 = std::move(m01);
+            m10 = std::move(m11);
+            m01 = std::move(previous01);
+            m11 = std::move(previous11);
+            odd = !odd;
+        }
+
+        // M <- M [[s00, s01], [s10, s11]] for single word entries, one pass per entry
+        void multiply_me_by(const uint64_t s00, const uint64_t s01, const uint64_t s10, const uint64_t s11) {
+            BigUint next00 = combine(m00, s00, m01, s10);
+            BigUint next01 = combine(m00, s01, m01, s11);
+            BigUint next10 = combine(m10, s00, m11, s10);
+            BigUint next11 = combine(m10, s01, m11, s11);
+            m00 = std::move(next00);
+            m01 = std::move(next01);
+            m10 = std::move(next10);
+            m11 = std::move(next11);
+        }
+
+        // x * sx + y * sy, the factors are below 2^32
+        static BigUint combine(const BigUint &x, const uint64_t sx, const BigUint &y, const uint64_t sy) {
+            constexpr int digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+            const auto &xDigits = x.get_digits();
+            const auto &yDigits = y.get_digits();
+            const std::size_t size = std::max(xDigits.size(), yDigits.size());
+            BigUint::Digits result(size + 5, 0);
+            uint64_t carry = 0;
+            for (std::size_t ii = 0; ii < result.size(); ii++) {
+                const uint64_t xDigit = ii < xDigits.size() ? xDigits[ii] : 0;
+                const uint64_t yDigit = ii < yDigits.size() ? yDigits[ii] : 0;
+                const uint64_t sum = xDigit * sx + yDigit * sy + carry;
+                result[ii] = static_cast<BigUint::DigitType>(sum);
+                carry = sum >> digitBits;
+            }
+
+            BigUint combined;
+            combined.set_digits(result);
+            return combined;
+        }
+
+        // M <- M rhs
+        void multiply_me_by(const QuotientMatrix &rhs) {
+            BigUint next00 = m00 * rhs.m00 + m01 * rhs.m10;
+            BigUint next01 = m00 * rhs.m01 + m01 * rhs.m11;
+            BigUint next10 = m10 * rhs.m00 + m11 * rhs.m10;
+            BigUint next11 = m10 * rhs.m01 + m11 * rhs.m11;
+            m00 = std::move(next00);
+            m01 = std::move(next01);
+            m10 = std::move(next10);
+            m11 = std::move(next11);
+            odd = odd != rhs.odd;
+        }
+    };
+
+    // Only the last quotients are kept, enough to step back over the few a truncated operand may get wrong
+    constexpr std::size_t MAX_TRAILING_QUOTIENTS = 16;
+
+    struct HalfGcdState {
+        QuotientMatrix matrix;
+        BigUint a;
+        BigUint b;
+        std::vector<BigUint> trailingQuotients;
+
+        void record(BigUint q) {
+            if (trailingQuotients.size() == 2 * MAX_TRAILING_QUOTIENTS) {
+                using diff_t = std::vector<BigUint>::difference_type;
+                trailingQuotients.erase(trailingQuotients.begin(), trailingQuotients.begin() + static_cast<diff_t>(MAX_TRAILING_QUOTIENTS));
+            }
+            trailingQuotients.push_back(std::move(q));
+        }
+
+        void euclid_step(const bool trackMatrix) {
+            auto [quotient, remainder] = a.divide_by(b);
+            a = std::move(b);
+            b = std::move(remainder);
+            if (trackMatrix) {
+                matrix.push_quotient(quotient);
+            }
+            record(std::move(quotient));
+        }
+
+        // As many quotients as the leading double digits determine, without taking b to stop bits or below
+        void lehmer_step(const std::size_t stop, const bool trackMatrix) {
+            constexpr std::size_t leadingBits = 2 * std::numeric_limits<BigUint::DigitType>::digits;
+            const std::size_t shift = a.bit_length() - leadingBits;
+            auto x = static_cast<int64_t>(read_bits(a.get_digits(), shift) & 0xFFFF'FFFF);
+            auto y = static_cast<int64_t>(read_bits(b.get_digits(), shift) & 0xFFFF'FFFF);
+
+            int64_t A = 1, B = 0, C = 0, D = 1;
+            bool odd = false;
+            while (y + C != 0 && y + D != 0 && static_cast<std::size_t>(std::bit_width(static_cast<uint64_t>(y))) + shift > stop + 2) {
+                const int64_t q = (x + A) / (y + C);
+                if (q != (x + B) / (y + D)) {
+                    break;
+                }
+
+                int64_t t = A - q * C;
+                A = C;
+                C = t;
+                t = B - q * D;
+                B = D;
+                D = t;
+                t = x - q * y;
+                x = y;
+                y = t;
+                odd = !odd;
+                record(BigUint(static_cast<BigUint::WideDigitType>(q)));
+            }
+
+            if (B == 0) {
+                euclid_step(trackMatrix);
+                return;
+            }
+
+            BigUint::Digits aDigits = a.get_digits();
+            BigUint::Digits bDigits = b.get_digits();
+            apply_cofactors(aDigits, bDigits, A, B, C, D);
+            a.set_digits(aDigits);
+            b.set_digits(bDigits);
+            if (trackMatrix) {
+                // The inverse of [[A, B], [C, D]] has the absolute values of its entries
+                const auto magnitude = [](const int64_t value) {
+                    return static_cast<uint64_t>(value < 0 ? -value : value);
+                };
+                matrix.multiply_me_by(magnitude(D), magnitude(B), magnitude(C), magnitude(A));
+                matrix.odd = matrix.odd != odd;
+            }
+        }
+    };
+
+    // high 2^shift + det(M) (positive - negative), nullopt when negative
+    std::optional<BigUint> recombine(const BigUint &high, const std::size_t shift, BigUint positive, BigUint negative, const bool odd) {
+        if (odd) {
+            std::swap(positive, negative);
+        }
+
+        BigUint result = high.shift_left_bits(shift);
+        if (positive >= negative) {
+            result += positive - negative;
+            return result;
+        }
+
+        const BigUint difference = negative - positive;
+        if (result < difference) {
+            return std::nullopt;
+        }
+        return result - difference;
+    }
+
+    // (alpha, beta) = M^-1 (a, b) for a = aHigh 2^shift + aLow, b = bHigh 2^shift + bLow, given
+    // (alphaHigh, betaHigh) = M^-1 (aHigh, bHigh). Only when it continues the remainder sequence
+    // of (a, b): alpha > beta >= 0
+    std::optional<std::pair<BigUint, BigUint>> reduce_by(const QuotientMatrix &matrix,
+                                                         const BigUint &alphaHigh, const BigUint &betaHigh,
+                                                         const BigUint &aLow, const BigUint &bLow, const std::size_t shift) {
+        // det(M) M^-1 = [[m11, -m01], [-m10, m00]]
+        auto alpha = recombine(alphaHigh, shift, matrix.m11 * aLow, matrix.m01 * bLow, matrix.odd);
+        auto beta = recombine(betaHigh, shift, matrix.m00 * bLow, matrix.m10 * aLow, matrix.odd);
+        if (!alpha || !beta || *alpha <= *beta) {
+            return std::nullopt;
+        }
+
+        return std::make_pair(std::move(*alpha), std::move(*beta));
+    }
+
+    constexpr std::size_t HALF_GCD_BASE_BITS = 1'024;
+
+    // Walks the remainder sequence of a >= b until b has at most stop bits, using the
+    // quotients of the truncated leading parts (Schoenhage / Moeller): two recursive calls
+    // on half sized operands, each checked against the full operands before it is accepted.
+    // NOLINTNEXTLINE(misc-no-recursion)
+    HalfGcdState half_gcd(BigUint a, BigUint b, const std::size_t stop, const bool trackMatrix = true) {
+        HalfGcdState state{QuotientMatrix{}, std::move(a), std::move(b), {}};
+        while (state.b != BigUint::ZERO && state.b.bit_length() > stop) {
+            const std::size_t bits = state.a.bit_length();
+            if (bits <= HALF_GCD_BASE_BITS) {
+                if (bits <= 2 * std::numeric_limits<BigUint::DigitType>::digits) {
+                    state.euclid_step(trackMatrix);
+                }
+                else {
+                    state.lehmer_step(stop, trackMatrix);
+                }
+                continue;
+            }
+
+            if (4 * stop < bits) {
+                // Far target, halve the operands first. Without this a call with stop near zero, as the full walk of
+                // extended_gcd makes, would keep shift = stop and recurse on untruncated operands, which is quadratic
+                HalfGcdState sub = half_gcd(state.a, state.b, bits / 2, trackMatrix);
+                if (sub.trailingQuotients.empty()) {
+                    state.euclid_step(trackMatrix);
+                    continue;
+                }
+
+                state.a = std::move(sub.a);
+                state.b = std::move(sub.b);
+                if (trackMatrix) {
+                    state.matrix.multiply_me_by(sub.matrix);
+                }
+                for (auto &quotient : sub.trailingQuotients) {
+                    state.record(std::move(quotient));
+                }
+                continue;
+            }
+
+            // Quotients needed to drop (bits - stop) bits depend on about twice as many leading bits
+            const std::size_t drop = bits - stop;
+            std::size_t shift = stop;
+            std::size_t subStop = drop / 2;
+            if (2 * drop < bits) {
+                shift = bits - 2 * drop;
+                subStop = drop;
+            }
+
+            HalfGcdState sub = half_gcd(state.a.shift_right_bits(shift), state.b.shift_right_bits(shift), subStop);
+            const BigUint aLow = low_bits(state.a, shift);
+            const BigUint bLow = low_bits(state.b, shift);
+            std::optional<std::pair<BigUint, BigUint>> reduced;
+            while (!sub.matrix.is_identity()) {
+                reduced = reduce_by(sub.matrix, sub.a, sub.b, aLow, bLow, shift);
+                if (reduced || sub.trailingQuotients.empty()) {
+                    break;
+                }
+
+                // Step back over the last quotient: (a, b) <- (q a + b, a)
+                const BigUint &quotient = sub.trailingQuotients.back();
+                sub.matrix.pop_quotient(quotient);
+                BigUint previousA = quotient * sub.a + sub.b;
+                sub.b = std::move(sub.a);
+                sub.a = std::move(previousA);
+                sub.trailingQuotients.pop_back();
+            }
+
+            if (!reduced) {
+                state.euclid_step(trackMatrix);
+                continue;
+            }
+
+            state.a = std::move(reduced->first);
+            state.b = std::move(reduced->second);
+            if (trackMatrix) {
+                state.matrix.multiply_me_by(sub.matrix);
+            }
+            for (auto &quotient : sub.trailingQuotients) {
+                state.record(std::move(quotient));
+            }
+        }
+
+        return state;
+    }
+}
+
+BigUint BigUint::subquadratic_gcd(BigUint a, BigUint b) {
+    if (a < b) {
+        std::swap(a, b);
+    }
+
+    while (b.digits_.size() >= HALF_GCD_MIN_DIGITS) {
+        const std::size_t stop = a.bit_length() / 2;
+        HalfGcdState state = half_gcd(std::move(a), std::move(b), stop, false);
+        a = std::move(state.a);
+        b = std::move(state.b);
+        if (b != BigUint::ZERO) {
+            // b is now below half the size of the original operands, a is not guaranteed to be
+            BigUint remainder = a % b;
+            a = std::move(b);
+            b = std::move(remainder);
+        }
+    }
+
+    return lehmer_gcd(std::move(a), std::move(b));
+}
+
+ExtendedGcd BigUint::extended_gcd(const BigUint &a, const BigUint &b) {
+    if (b == BigUint::ZERO) {
+        return {a, {BigUint::ONE, false}, {BigUint::ZERO, false}};
+    }
+
+    if (a == BigUint::ZERO) {
+        return {b, {BigUint::ZERO, false}, {BigUint::ONE, false}};
+    }
+
+    // Walk the whole remainder sequence of (larger, smaller) keeping the quotient matrix M:
+    // gcd = det(M) (m11 larger - m01 smaller)
+    const bool swapped = a < b;
+    HalfGcdState state = swapped ? half_gcd(b, a, 0) : half_gcd(a, b, 0);
+    SignedBigUint largerCoefficient{std::move(state.matrix.m11), state.matrix.odd};
+    SignedBigUint smallerCoefficient{std::move(state.matrix.m01), !state.matrix.odd};
+    for (auto *coefficient : {&largerCoefficient, &smallerCoefficient}) {
+        if (coefficient->magnitude == BigUint::ZERO) {
+            coefficient->negative = false;
+        }
+    }
+
+    if (swapped) {
+        return {std::move(state.a), std::move(smallerCoefficient), std::move(largerCoefficient)};
+    }
+    return {std::move(state.a), std::move(largerCoefficient), std::move(smallerCoefficient)};
+}
+
+std::optional<BigUint> BigUint::mod_inverse(const BigUint &value, const BigUint &mod) {
+    if (mod == BigUint::ZERO) {
+        throw std::runtime_error("modulus value cannot be zero");
+    }
+
+    if (mod == BigUint::ONE) {
+        throw std::runtime_error("modulus value cannot be one");
+    }
+
+    BigUint reduced = value % mod;
+    if (reduced == BigUint::ZERO) {
+        return std::nullopt;
+    }
+
+    if (mod.is_odd() && mod.digits_.size() <= BINARY_GCD_MAX_DIGITS) {
+        return binary_mod_inverse(std::move(reduced), mod);
+    }
+
+    const auto [gcd, coefficient, _] = extended_gcd(reduced, mod);
+    if (gcd != BigUint::ONE) {
+        return std::nullopt;
+    }
+
+    return coefficient.mod(mod);
+}
+
+std::optional<std::vector<BigUint>> BigUint::batch_mod_inverse(std::span<const BigUint> values, const BigUint &mod, std::size_t threads) {
+    if (mod == BigUint::ZERO) {
+        throw std::runtime_error("modulus value cannot be zero");
+    }
+
+    if (mod == BigUint::ONE) {
+        throw std::runtime_error("modulus value cannot be one");
+    }
+
+    std::vector<BigUint> inverses(values.size());
+    threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(values.size(), 1));
+    if (threads == 1) {
+        if (!batch_mod_inverse_chunk(values, mod, inverses)) {
+            return std::nullopt;
+        }
+        return inverses;
+    }
+
+    const std::size_t chunkSize = (values.size() + threads - 1) / threads;
+    std::vector<char> succeeded(threads, 0);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (std::size_t ii = 0; ii < threads; ii++) {
+        const std::size_t begin = std::min(ii * chunkSize, values.size());
+        const std::size_t count = std::min(chunkSize, values.size() - begin);
+        workers.emplace_back([&, ii, begin, count] {
+            succeeded[ii] = batch_mod_inverse_chunk(values.subspan(begin, count), mod, std::span(inverses).subspan(begin, count));
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    if (std::ranges::find(succeeded, 0) != succeeded.end()) {
+        return std::nullopt;
+    }
+    return inverses;
+}
+
+bool BigUint::batch_mod_inverse_chunk(std::span<const BigUint> values, const BigUint &mod, std::span<BigUint> inverses) {
+    if (values.empty()) {
+        return true;
+    }
+
+    // inverses[ii] holds the prefix product values[0] * ... * values[ii] until it is replaced by the inverse
+    inverses[0] = values[0] % mod;
+    for (std::size_t ii = 1; ii < values.size(); ii++) {
+        inverses[ii] = inverses[ii - 1] * values[ii] % mod;
+    }
+
+    auto inverse = mod_inverse(inverses.back(), mod);
+    if (!inverse) {
+        return false;
+    }
+
+    for (std::size_t ii = values.size() - 1; ii > 0; ii--) {
+        inverses[ii] = *inverse * inverses[ii - 1] % mod;
+        *inverse = *inverse * values[ii] % mod;
+    }
+    inverses[0] = std::move(*inverse);
+    return true;
+}
+
+int BigUint::jacobi(BigUint a, BigUint n) {
+    if (n.is_even()) {
+        throw std::runtime_error("Jacobi symbol needs an odd modulus");
+    }
+
+    // Both operands shrink by subtraction and shifts, the signs only need the low digit of n
+    int result = 1;
+    while (true) {
+        const auto aWord = a.as_native_word();
+        const auto nWord = n.as_native_word();
+        if (aWord && nWord) {
+            return result * word::jacobi(*aWord, *nWord);
+        }
+        if (a == BigUint::ZERO) {
+            return n == BigUint::ONE ? result : 0;
+        }
+
+        const auto zeros = a.count_trailing_zeros();
+        a.shift_me_right_bits(zeros);
+        // (2 / n) = -1 exactly when n = 3, 5 (mod 8)
+        const auto nMod8 = n.get_least_significant_digit() % 8;
+        if (zeros % 2 == 1 && (nMod8 == 3 || nMod8 == 5)) {
+            result = -result;
+        }
+        // quadratic reciprocity for odd a and n, then a - n is even
+        if (a < n) {
+            std::swap(a, n);
+            if (a.get_least_significant_digit() % 4 == 3 && n.get_least_significant_digit() % 4 == 3) {
+                result = -result;
+            }
+        }
+        subtract_in_place(a.digits_, n.digits_);
+    }
+}
+
+std::optional<BigUint> BigUint::mod_sqrt(const BigUint &a, const BigUint &p) {
+    if (p.is_even()) {
+        throw std::runtime_error("square root needs an odd prime modulus");
+    }
+
+    const BigUint reduced = a < p ? a : a % p;
+    if (const auto pWord = p.as_native_word()) {
+        const auto root = word::sqrt_mod(*reduced.as_native_word(), *pWord);
+        return root ? std::optional(from_native_word(*root)) : std::nullopt;
+    }
+    if (reduced == BigUint::ZERO) {
+        return BigUint::ZERO;
+    }
+    if (jacobi(reduced, p) != 1) {
+        return std::nullopt;
+    }
+
+    const Montgomery montgomery(p);
+    const BigUint value = montgomery.to_montgomery(reduced);
+    const auto pMod8 = p.get_least_significant_digit() % 8;
+    BigUint root;
+    if (pMod8 % 4 == 3) {
+        // a^((p + 1) / 4), the root because a^((p - 1) / 2) = 1
+        root = montgomery.pow(value, p.plus_one().shift_right_bits(2));
+    }
+    else if (pMod8 == 5) {
+        // Atkin: b = (2a)^((p - 5) / 8) and i = 2a b^2 is a square root of -1, the root is a b (i - 1)
+        const BigUint twice = montgomery.add(value, value);
+        const BigUint b = montgomery.pow(twice, (p - static_cast<DigitType>(5)).shift_right_bits(3));
+        const BigUint i = montgomery.multiply(twice, montgomery.square(b));
+        root = montgomery.multiply(montgomery.multiply(value, b), montgomery.subtract(i, montgomery.one()));
+    }
+    else {
+        // Tonelli-Shanks: p - 1 = odd 2^shift, z generates the 2-Sylow subgroup
+        const BigUint pMinusOne = p.minus_one();
+        const std::size_t shift = pMinusOne.count_trailing_zeros();
+        const BigUint odd = pMinusOne.shift_right_bits(shift);
+        DigitType z = 2;
+        while (jacobi(BigUint(z), p) != -1) {
+            z++;
+        }
+
+        std::size_t order = shift;
+        BigUint c = montgomery.pow(montgomery.to_montgomery(BigUint(z)), odd);
+        BigUint t = montgomery.pow(value, odd);
+        root = montgomery.pow(value, odd.plus_one().shift_right_bits(1));
+        while (t != montgomery.one()) {
+            // least i with t^(2^i) = 1
+            std::size_t ii = 0;
+            for (BigUint power = t; power != montgomery.one(); power = montgomery.square(power)) {
+                ii++;
+                if (ii == order) {
+                    return std::nullopt;
+                }
+            }
+
+            BigUint b = std::move(c);
+            for (std::size_t jj = 0; jj + ii + 1 < order; jj++) {
+                b = montgomery.square(b);
+            }
+            order = ii;
+            c = montgomery.square(b);
+            t = montgomery.multiply(t, c);
+            root = montgomery.multiply(root, b);
+        }
+    }
+
+    // p that is not prime can pass the Jacobi symbol without a root
+    if (montgomery.square(root) != value) {
+        return std::nullopt;
+    }
+    return montgomery.from_montgomery(root);
+}
+
+namespace {
+    void trim(BigUint::Digits &digits) {
+        while (digits.size() > 1 && digits.back() == 0) {
+            digits.pop_back();
+        }
+    }
+
+    bool is_one(const BigUint::Digits &digits) {
+        return digits.size() == 1 && digits[0] == 1;
+    }
+
+    std::strong_ordering compare(const BigUint::Digits &lhs, const BigUint::Digits &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return lhs.size() <=> rhs.size();
+        }
+
+        for (std::size_t ii = lhs.size(); ii-- > 0;) {
+            if (lhs[ii] != rhs[ii]) {
+                return lhs[ii] <=> rhs[ii];
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+    // value += factor * mod
+    void add_multiple(BigUint::Digits &value, const BigUint::DigitType factor, const BigUint::Digits &mod) {
+        constexpr int digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+        value.resize(std::max(value.size(), mod.size()) + 1, 0);
+        BigUint::WideDigitType carry = 0;
+        for (std::size_t ii = 0; ii < value.size(); ii++) {
+            const BigUint::WideDigitType modDigit = ii < mod.size() ? mod[ii] : 0;
+            const BigUint::WideDigitType sum = value[ii] + modDigit * factor + carry;
+            value[ii] = static_cast<BigUint::DigitType>(sum);
+            carry = sum >> digitBits;
+        }
+        trim(value);
+    }
+
+    void shift_right_in_place(BigUint::Digits &value, const unsigned bits) {
+        constexpr unsigned digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+        for (std::size_t ii = 0; ii < value.size(); ii++) {
+            const BigUint::WideDigitType high = ii + 1 < value.size() ? value[ii + 1] : 0;
+            value[ii] = static_cast<BigUint::DigitType>(((high << digitBits) | value[ii]) >> bits);
+        }
+        trim(value);
+    }
+
+    // value <- value / 2^bits (mod mod), bits <= digit size, modInverse = -mod^-1 (mod BASE)
+    void divide_by_power_of_two(BigUint::Digits &value, const unsigned bits, const BigUint::Digits &mod, const BigUint::DigitType modInverse) {
+        const BigUint::WideDigitType mask = (BigUint::WideDigitType{1} << bits) - 1;
+        const auto factor = static_cast<BigUint::DigitType>((static_cast<BigUint::WideDigitType>(value[0]) * modInverse) & mask);
+        if (factor != 0) {
+            add_multiple(value, factor, mod);
+        }
+        if (bits == std::numeric_limits<BigUint::DigitType>::digits) {
+            value.erase(value.begin());
+            if (value.empty()) {
+                value.push_back(0);
+            }
+        }
+        else {
+            shift_right_in_place(value, bits);
+        }
+    }
+}
+
+// Binary extended algorithm working on the digits in place, requires an odd modulus and 0 < value < mod
+std::optional<BigUint> BigUint::binary_mod_inverse(BigUint value, const BigUint &mod) {
+    constexpr unsigned digitBits = std::numeric_limits<DigitType>::digits;
+    const Digits &m = mod.digits_;
+
+    // -m^-1 modulo BASE by Newton iteration, each step doubles the correct low bits
+    WideDigitType inverse = m[0];
+    for (int ii = 0; ii < 4; ii++) {
+        inverse *= 2 - m[0] * inverse;
+    }
+    const auto modInverse = static_cast<DigitType>(0 - inverse);
+
+    // Invariants: u = x1 * value, v = x2 * value (mod m)
+    Digits u = std::move(value.digits_);
+    Digits v = m;
+    Digits x1{1};
+    Digits x2{0};
+    const auto strip = [&](Digits &w, Digits &x) {
+        std::size_t words = 0;
+        while (w[words] == 0) {
+            words++;
+        }
+        std::size_t zeros = words * digitBits + static_cast<std::size_t>(std::countr_zero(w[words]));
+        w.erase(w.begin(), w.begin() + static_cast<std::ptrdiff_t>(zeros / digitBits));
+        if (zeros % digitBits != 0) {
+            shift_right_in_place(w, static_cast<unsigned>(zeros % digitBits));
+        }
+        for (; zeros > 0; zeros -= std::min<std::size_t>(zeros, digitBits)) {
+            divide_by_power_of_two(x, static_cast<unsigned>(std::min<std::size_t>(zeros, digitBits)), m, modInverse);
+        }
+    };
+    // x <- x - y (mod m)
+    const auto mod_subtract = [&m](Digits &x, const Digits &y) {
+        if (compare(x, y) == std::strong_ordering::less) {
+            add_multiple(x, 1, m);
+        }
+        subtract_in_place(x, y);
+    };
+
+    while (!is_one(u) && !is_one(v)) {
+        if ((u.size() == 1 && u[0] == 0) || (v.size() == 1 && v[0] == 0)) {
+            return std::nullopt;
+        }
+
+        strip(u, x1);
+        strip(v, x2);
+        if (compare(u, v) != std::strong_ordering::less) {
+            subtract_in_place(u, v);
+            mod_subtract(x1, x2);
+        }
+        else {
+            subtract_in_place(v, u);
+            mod_subtract(x2, x1);
+        }
+    }
+
+    BigUint result;
+    result.set_digits(is_one(u) ? x1 : x2);
+    return result;
+}
+
+BigUint SignedBigUint::mod(const BigUint &mod) const {
+    BigUint reduced = magnitude % mod;
+    if (!negative || reduced == BigUint::ZERO) {
+        return reduced;
+    }
+
+    return mod - reduced;
+}
+
+// FNV-1a over the digits, finished by a multiply and shifts so that the low bits power of two tables use are well mixed
+std::size_t std::hash<BigUint>::operator()(const BigUint &value) const noexcept {
+    uint64_t hash = 14'695'981'039'346'656'037ULL;
+    for (const auto digit : value.get_digits()) {
+        hash ^= digit;
+        hash *= 1'099'511'628'211ULL;
+    }
+    hash ^= hash >> 32;
+    hash *= 0x9E37'79B9'7F4A'7C15ULL;
+    hash ^= hash >> 29;
+    return static_cast<std::size_t>(hash);
+}
+
+// lhs -= rhs without reallocating, requires lhs >= rhs
+void BigUint::subtract_in_place(Digits &lhs, const Digits &rhs) {
+    DigitType borrow = 0;
+    for (std::size_t ii = 0; ii < lhs.size(); ii++) {
+        const WideDigitType subtrahend = static_cast<WideDigitType>(ii < rhs.size() ? rhs[ii] : 0) + borrow;
+        if (ii >= rhs.size() && borrow == 0) {
+            break;
+        }
+
+        if (lhs[ii] >= subtrahend) {
+            lhs[ii] = static_cast<DigitType>(lhs[ii] - subtrahend);
+            borrow = 0;
+        }
+        else {
+            lhs[ii] = static_cast<DigitType>(BASE + lhs[ii] - subtrahend);
+            borrow = 1;
+        }
+    }
+
+    while (lhs.size() > 1 && lhs.back() == 0) {
+        lhs.pop_back();
+    }
+}
+
 std::ostream& operator<<(std::ostream& os, const BigUint& bigUint) {
     return os << bigUint.to_base10_string();
 }
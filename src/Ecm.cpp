@@ -0,0 +1,214 @@
+#include "Ecm.h"
+#include "Montgomery.h"
+#include "Sieve.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace factor
+{
+    namespace {
+        // Giant step, 2 * 3 * 5 * 7 * 11. A prime above 11 is m D +- j with j coprime to D, so only the 240 such odd j
+        // below D / 2 keep a baby step
+        constexpr uint64_t GIANT_STEP = 2'310;
+        // How many primes pass between two looks at the stop flag
+        constexpr std::size_t STOP_CHECK_INTERVAL = 256;
+
+        // Projective x-coordinate X : Z, in Montgomery form
+        struct Point {
+            BigUint x;
+            BigUint z;
+        };
+
+        // Curve B y^2 = x^3 + A x^2 + x, only (A + 2) / 4 matters for x-only arithmetic
+        class Curve {
+        public:
+            Curve(const Montgomery &montgomery, BigUint a24) : m_(montgomery), a24_(std::move(a24)) {}
+
+            [[nodiscard]] Point twice(const Point &point) const {
+                const BigUint sum = m_.square(m_.add(point.x, point.z));
+                const BigUint difference = m_.square(m_.subtract(point.x, point.z));
+                const BigUint product = m_.subtract(sum, difference); // 4 x z
+                return {m_.multiply(sum, difference), m_.multiply(product, m_.add(difference, m_.multiply(a24_, product)))};
+            }
+
+            // lhs + rhs given lhs - rhs
+            [[nodiscard]] Point add(const Point &lhs, const Point &rhs, const Point &difference) const {
+                const BigUint cross = m_.multiply(m_.subtract(lhs.x, lhs.z), m_.add(rhs.x, rhs.z));
+                const BigUint other = m_.multiply(m_.add(lhs.x, lhs.z), m_.subtract(rhs.x, rhs.z));
+                return {m_.multiply(difference.z, m_.square(m_.add(cross, other))), m_.multiply(difference.x, m_.square(m_.subtract(cross, other)))};
+            }
+
+            // Montgomery ladder, returns k P and (k + 1) P for k > 0
+            [[nodiscard]] std::pair<Point, Point> ladder(const Point &point, const uint64_t k) const {
+                Point low = point;
+                Point high = twice(point);
+                for (int bit = std::bit_width(k) - 2; bit >= 0; bit--) {
+                    if ((k >> bit) & 1) {
+                        low = add(high, low, point);
+                        high = twice(high);
+                    }
+                    else {
+                        high = add(high, low, point);
+                        low = twice(low);
+                    }
+                }
+                return {std::move(low), std::move(high)};
+            }
+
+        private:
+            const Montgomery &m_;
+            BigUint a24_;
+        };
+
+        // 1 < gcd < number, a factor found by this curve
+        std::optional<BigUint> proper_divisor(const Montgomery &montgomery, const BigUint &value) {
+            BigUint divisor = BigUint::gcd(montgomery.from_montgomery(value), montgomery.modulus());
+            if (divisor == BigUint::ONE || divisor == montgomery.modulus()) {
+                return std::nullopt;
+            }
+            return divisor;
+        }
+
+        std::optional<BigUint> run_curve(const Montgomery &montgomery, const uint64_t sigma, const std::vector<uint64_t> &primes, const uint64_t b1, const uint64_t b2, const std::atomic<bool> &stop) {
+            const BigUint &number = montgomery.modulus();
+            const auto constant = [&montgomery](const uint64_t value) { return montgomery.to_montgomery(BigUint::from_native_word(value)); };
+
+            // Suyama: u = sigma^2 - 5, v = 4 sigma, x0 = u^3, z0 = v^3, (A + 2) / 4 = (v - u)^3 (3 u + v) / (16 u^3 v)
+            const BigUint s = constant(sigma);
+            const BigUint u = montgomery.subtract(montgomery.square(s), constant(5));
+            const BigUint v = montgomery.multiply(constant(4), s);
+            const BigUint u3 = montgomery.multiply(montgomery.square(u), u);
+            const BigUint v3 = montgomery.multiply(montgomery.square(v), v);
+            const BigUint vu = montgomery.subtract(v, u);
+            const BigUint numerator = montgomery.multiply(montgomery.multiply(montgomery.square(vu), vu), montgomery.add(montgomery.multiply(constant(3), u), v));
+            const BigUint denominator = montgomery.from_montgomery(montgomery.multiply(montgomery.multiply(constant(16), u3), v));
+            const auto inverse = BigUint::mod_inverse(denominator, number);
+            if (!inverse) {
+                const BigUint divisor = BigUint::gcd(denominator, number);
+                return divisor != number ? std::optional(divisor) : std::nullopt;
+            }
+
+            const Curve curve(montgomery, montgomery.multiply(numerator, montgomery.to_montgomery(*inverse)));
+            Point point{u3, v3};
+
+            // Stage 1: Q = (product of all prime powers up to b1) P
+            std::size_t index = 0;
+            for (; index < primes.size() && primes[index] <= b1; index++) {
+                if (index % STOP_CHECK_INTERVAL == 0 && stop.load(std::memory_order_relaxed)) {
+                    return std::nullopt;
+                }
+                const uint64_t prime = primes[index];
+                uint64_t power = prime;
+                while (power <= b1 / prime) {
+                    power *= prime;
+                }
+                point = curve.ladder(point, power).first;
+            }
+            // stage 2 starts at the first giant step, so the primes of (b1, D / 2) it would reach join stage 1 once
+            for (; index < primes.size() && primes[index] < GIANT_STEP / 2; index++) {
+                point = curve.ladder(point, primes[index]).first;
+            }
+            if (auto divisor = proper_divisor(montgomery, point.z)) {
+                return divisor;
+            }
+            if (b2 <= b1) {
+                return std::nullopt;
+            }
+
+            // Stage 2: a prime q = m D +- j with j < D / 2 kills Q exactly when X(m D Q) Z(j Q) = X(j Q) Z(m D Q) mod p
+            // the odd multiples j Q come from a chain of additions of 2 Q, only the ones coprime to D are stored
+            std::vector<Point> baby(GIANT_STEP / 2);
+            {
+                const Point twice = curve.twice(point);
+                Point lower = point;
+                Point upper = curve.add(twice, point, point);
+                baby[1] = point;
+                for (uint64_t jj = 3; jj < GIANT_STEP / 2; jj += 2) {
+                    Point following = curve.add(upper, twice, lower);
+                    lower = std::move(upper);
+                    if (std::gcd(jj, GIANT_STEP) == 1) {
+                        baby[jj] = lower;
+                    }
+                    upper = std::move(following);
+                }
+            }
+
+            const Point giant = curve.ladder(point, GIANT_STEP).first;
+            uint64_t m = std::max<uint64_t>((b1 + GIANT_STEP / 2) / GIANT_STEP, 1);
+            auto [current, next] = curve.ladder(giant, m);
+            Point previous;
+            BigUint product = montgomery.one();
+            for (std::size_t checked = 0; index < primes.size() && primes[index] <= b2; checked++) {
+                if (checked % STOP_CHECK_INTERVAL == 0 && stop.load(std::memory_order_relaxed)) {
+                    return std::nullopt;
+                }
+
+                const uint64_t centre = m * GIANT_STEP;
+                if (primes[index] > centre + GIANT_STEP / 2) {
+                    previous = std::move(current);
+                    current = std::move(next);
+                    next = curve.add(current, giant, previous);
+                    m++;
+                    continue;
+                }
+
+                const uint64_t prime = primes[index++];
+                const Point &step = baby[prime > centre ? prime - centre : centre - prime];
+                product = montgomery.multiply(product, montgomery.subtract(montgomery.multiply(current.x, step.z), montgomery.multiply(step.x, current.z)));
+            }
+            return proper_divisor(montgomery, product);
+        }
+    }
+
+    std::optional<BigUint> ecm(const BigUint &number, const uint64_t b1, uint64_t b2, const std::size_t curves, std::size_t threads, const std::size_t first_curve) {
+        if (number < BigUint(4) || first_curve >= curves) {
+            return std::nullopt;
+        }
+        if (number.is_even()) {
+            return BigUint::TWO;
+        }
+
+        b2 = std::max(b1, b2);
+        const auto primes = sieve::primes_in_range(2, b2 + 1);
+        const Montgomery montgomery(number);
+        threads = std::clamp<std::size_t>(threads, 1, curves - first_curve);
+        std::atomic<std::size_t> next_curve = first_curve;
+        std::atomic<bool> stop = false;
+        std::mutex mutex;
+        std::optional<BigUint> result;
+
+        const auto worker = [&]() {
+            for (std::size_t curve = next_curve++; curve < curves && !stop.load(); curve = next_curve++) {
+                // sigma must avoid 0, 1, 3 and 5
+                auto divisor = run_curve(montgomery, 6 + curve, primes, b1, b2, stop);
+                if (divisor) {
+                    const std::lock_guard lock(mutex);
+                    if (!result) {
+                        result = std::move(divisor);
+                    }
+                    stop = true;
+                }
+            }
+        };
+
+        if (threads == 1) {
+            worker();
+            return result;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (std::size_t ii = 0; ii < threads; ii++) {
+            workers.emplace_back(worker);
+        }
+        for (auto &thread : workers) {
+            thread.join();
+        }
+        return result;
+    }
+} // end namespace factor
@@ -0,0 +1,101 @@
+#include "FactorCache.h"
+#include <bit>
+#include <functional>
+#include <mutex>
+
+namespace {
+    // Fibonacci hashing, the shard comes from other bits of the hash than the buckets of the shard maps
+    constexpr uint64_t GOLDEN_RATIO = 0x9E37'79B9'7F4A'7C15ULL;
+
+    std::size_t bytes_of(const BigUint &number) {
+        return sizeof(BigUint) + number.get_digits().capacity() * sizeof(BigUint::DigitType);
+    }
+}
+
+FactorCache::FactorCache(const std::size_t max_bytes, const std::size_t shards)
+    : shardCount_(std::bit_ceil(std::max<std::size_t>(shards, 1))),
+      shardBytes_(max_bytes / shardCount_),
+      shards_(std::make_unique<Shard[]>(shardCount_)) {
+}
+
+std::optional<std::vector<BigUint>> FactorCache::find(const BigUint &number) const {
+    const Shard &shard = shard_of(number);
+    const std::shared_lock lock(shard.mutex);
+    const auto itr = shard.positions.find(number);
+    if (itr == shard.positions.end()) {
+        return std::nullopt;
+    }
+    const Entry &entry = *shard.entries[itr->second];
+    entry.referenced.store(true, std::memory_order_relaxed);
+    return entry.factors;
+}
+
+bool FactorCache::insert(const BigUint &number, std::vector<BigUint> factors) {
+    auto entry = std::make_unique<Entry>();
+    entry->bytes = sizeof(Entry) + bytes_of(number);
+    for (const auto &factor : factors) {
+        entry->bytes += bytes_of(factor);
+    }
+    if (entry->bytes > shardBytes_) {
+        return false;
+    }
+    entry->number = number;
+    entry->factors = std::move(factors);
+    // a new entry survives the first sweep of the clock
+    entry->referenced.store(true, std::memory_order_relaxed);
+
+    Shard &shard = shard_of(number);
+    const std::unique_lock lock(shard.mutex);
+    if (!shard.positions.try_emplace(number, shard.entries.size()).second) {
+        return false;
+    }
+    shard.bytes += entry->bytes;
+    shard.entries.push_back(std::move(entry));
+    evict(shard, shardBytes_);
+    return true;
+}
+
+std::size_t FactorCache::size() const {
+    std::size_t size = 0;
+    for (std::size_t ii = 0; ii < shardCount_; ii++) {
+        const std::shared_lock lock(shards_[ii].mutex);
+        size += shards_[ii].entries.size();
+    }
+    return size;
+}
+
+std::size_t FactorCache::bytes() const {
+    std::size_t bytes = 0;
+    for (std::size_t ii = 0; ii < shardCount_; ii++) {
+        const std::shared_lock lock(shards_[ii].mutex);
+        bytes += shards_[ii].bytes;
+    }
+    return bytes;
+}
+
+FactorCache::Shard & FactorCache::shard_of(const BigUint &number) const {
+    const uint64_t mixed = static_cast<uint64_t>(std::hash<BigUint>{}(number)) * GOLDEN_RATIO;
+    return shards_[(mixed >> 32) & (shardCount_ - 1)];
+}
+
+// Clears the flags of recently used entries and evicts the first one found without, until the shard fits its budget
+void FactorCache::evict(Shard &shard, const std::size_t budget) {
+    while (shard.bytes > budget) {
+        if (shard.hand >= shard.entries.size()) {
+            shard.hand = 0;
+        }
+        Entry &entry = *shard.entries[shard.hand];
+        if (entry.referenced.exchange(false, std::memory_order_relaxed)) {
+            shard.hand++;
+            continue;
+        }
+
+        shard.bytes -= entry.bytes;
+        shard.positions.erase(entry.number);
+        if (shard.hand + 1 != shard.entries.size()) {
+            shard.entries[shard.hand] = std::move(shard.entries.back());
+            shard.positions[shard.entries[shard.hand]->number] = shard.hand;
+        }
+        shard.entries.pop_back();
+    }
+}
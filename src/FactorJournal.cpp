@@ -0,0 +1,220 @@
+#include "FactorJournal.h"
+#include "MappedFile.h"
+#include <array>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr std::size_t RECORD_HEADER_BYTES = 8;
+
+    // Reflected CRC-32 of zlib and Ethernet, one table lookup per byte
+    constexpr std::array<uint32_t, 256> CRC_TABLE = [] {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t ii = 0; ii < 256; ii++) {
+            uint32_t crc = ii;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (crc & 1 ? 0xEDB8'8320 : 0);
+            }
+            table[ii] = crc;
+        }
+        return table;
+    }();
+
+    uint32_t crc32(const unsigned char *data, const std::size_t size) {
+        uint32_t crc = 0xFFFF'FFFF;
+        for (std::size_t ii = 0; ii < size; ii++) {
+            crc = (crc >> 8) ^ CRC_TABLE[(crc ^ data[ii]) & 0xFF];
+        }
+        return ~crc;
+    }
+
+    void put_uint32(std::string &out, const uint32_t value) {
+        for (int ii = 0; ii < 4; ii++) {
+            out.push_back(static_cast<char>(value >> (8 * ii)));
+        }
+    }
+
+    uint32_t get_uint32(const unsigned char *in) {
+        return in[0] | in[1] << 8 | in[2] << 16 | static_cast<uint32_t>(in[3]) << 24;
+    }
+
+    bool sync_to_disk(std::FILE *file) {
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+}
+
+FactorJournal::FactorJournal(const std::filesystem::path &path, const JournalOptions options)
+    : options_(options), path_(path) {
+    if (options_.flush_records == 0) {
+        throw std::runtime_error("journal flush record count cannot be zero");
+    }
+#ifdef _WIN32
+    file_ = _wfopen(path.c_str(), L"ab");
+#else
+    file_ = std::fopen(path.c_str(), "ab");
+#endif
+    if (file_ == nullptr) {
+        throw std::runtime_error("Could not open file " + path.string());
+    }
+    // records are gathered in our own buffer
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    writer_ = std::thread(&FactorJournal::write_loop, this);
+}
+
+FactorJournal::~FactorJournal() {
+    {
+        const std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    std::fclose(file_);
+}
+
+void FactorJournal::append(const BigUint &number, const std::vector<BigUint> &factors) {
+    std::string payload = number.to_base10_string();
+    for (const auto &factor : factors) {
+        payload += ' ';
+        payload += factor.to_base10_string();
+    }
+
+    auto *node = new Node;
+    node->record.reserve(RECORD_HEADER_BYTES + payload.size());
+    put_uint32(node->record, static_cast<uint32_t>(payload.size()));
+    put_uint32(node->record, crc32(reinterpret_cast<const unsigned char *>(payload.data()), payload.size()));
+    node->record += payload;
+
+    // Treiber stack push, the writer takes the whole stack at once
+    node->next = pending_.load(std::memory_order_relaxed);
+    while (!pending_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    if ((appended_.fetch_add(1, std::memory_order_relaxed) + 1) % options_.flush_records == 0) {
+        wake_.notify_one();
+    }
+}
+
+void FactorJournal::flush() {
+    std::unique_lock lock(mutex_);
+    const uint64_t request = ++flushRequested_;
+    wake_.notify_one();
+    flushed_.wait(lock, [this, request] { return flushServed_ >= request; });
+    if (failed_) {
+        throw std::runtime_error("Could not write journal " + path_.string());
+    }
+}
+
+void FactorJournal::write_loop() {
+    std::string buffer;
+    buffer.reserve(options_.buffer_bytes);
+    uint64_t appendedBefore = 0;
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_.wait_for(lock, options_.flush_interval, [this, appendedBefore] {
+            return stop_ || flushRequested_ > flushServed_ || appended_.load(std::memory_order_relaxed) - appendedBefore >= options_.flush_records;
+        });
+        // every append made before these requests is already on the stack
+        const uint64_t serving = flushRequested_;
+        const bool stopping = stop_;
+        appendedBefore = appended_.load(std::memory_order_relaxed);
+        lock.unlock();
+
+        const bool written = write_pending(buffer);
+
+        lock.lock();
+        failed_ = failed_ || !written;
+        flushServed_ = serving;
+        flushed_.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+bool FactorJournal::write_pending(std::string &buffer) {
+    Node *node = pending_.exchange(nullptr, std::memory_order_acquire);
+    if (node == nullptr) {
+        return true;
+    }
+
+    // the stack holds the newest record first
+    Node *oldest = nullptr;
+    while (node != nullptr) {
+        Node *next = node->next;
+        node->next = oldest;
+        oldest = node;
+        node = next;
+    }
+
+    bool written = true;
+    const auto write_buffer = [this, &buffer, &written] {
+        written = std::fwrite(buffer.data(), 1, buffer.size(), file_) == buffer.size() && written;
+        buffer.clear();
+    };
+    for (node = oldest; node != nullptr;) {
+        if (!buffer.empty() && buffer.size() + node->record.size() > options_.buffer_bytes) {
+            write_buffer();
+        }
+        buffer += node->record;
+        Node *next = node->next;
+        delete node;
+        node = next;
+    }
+    write_buffer();
+
+    written = std::fflush(file_) == 0 && written;
+    if (options_.fsync) {
+        written = sync_to_disk(file_) && written;
+    }
+    return written;
+}
+
+std::size_t FactorJournal::replay(const std::filesystem::path &path, const Visit &visit) {
+    if (!std::filesystem::exists(path)) {
+        return 0;
+    }
+
+    std::size_t records = 0;
+    std::size_t intact = 0;
+    std::size_t size;
+    {
+        const MappedFile file(path);
+        const auto bytes = file.bytes();
+        size = bytes.size();
+        while (size - intact >= RECORD_HEADER_BYTES) {
+            const unsigned char *record = bytes.data() + intact;
+            const uint32_t payloadSize = get_uint32(record);
+            if (payloadSize > size - intact - RECORD_HEADER_BYTES || crc32(record + RECORD_HEADER_BYTES, payloadSize) != get_uint32(record + 4)) {
+                break;
+            }
+
+            const std::string_view payload(reinterpret_cast<const char *>(record + RECORD_HEADER_BYTES), payloadSize);
+            std::vector<BigUint> numbers;
+            for (std::size_t begin = 0; begin < payload.size();) {
+                const std::size_t end = std::min(payload.find(' ', begin), payload.size());
+                numbers.push_back(BigUint::from_base10_string(std::string(payload.substr(begin, end - begin))));
+                begin = end + 1;
+            }
+            if (numbers.empty()) {
+                throw std::runtime_error("empty record in journal " + path.string());
+            }
+            visit(numbers.front(), std::vector<BigUint>(numbers.begin() + 1, numbers.end()));
+            intact += RECORD_HEADER_BYTES + payloadSize;
+            records++;
+        }
+    }
+
+    // a torn tail is cut off so new records follow the last intact one
+    if (intact < size) {
+        std::filesystem::resize_file(path, intact);
+    }
+    return records;
+}
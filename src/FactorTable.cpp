@@ -0,0 +1,297 @@
+#include "FactorTable.h"
+#include "MappedFile.h"
+#include "Sieve.h"
+#include "WordArithmetic.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    constexpr std::size_t INITIAL_SLOTS = 16;
+    constexpr std::size_t MIN_CHUNK_BYTES = 1 << 20;
+    constexpr std::size_t WORD_DIGITS = 19;
+
+    struct ParsedChunk {
+        std::vector<std::pair<BigUint, std::vector<BigUint>>> entries;
+        std::size_t lines = 0;
+        std::optional<std::pair<std::size_t, std::string>> error; // line within the chunk and what is wrong with it
+    };
+
+    bool is_digit(const unsigned char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // Up to 19 digits fit a word, longer numbers take four digits per BigUint step
+    BigUint parse_decimal(const unsigned char *begin, const unsigned char *end) {
+        const auto length = static_cast<std::size_t>(end - begin);
+        const std::size_t head = length <= WORD_DIGITS ? length : (length % 4 == 0 ? 4 : length % 4);
+        uint64_t value = 0;
+        for (std::size_t ii = 0; ii < head; ii++) {
+            value = 10 * value + (begin[ii] - '0');
+        }
+        BigUint number = BigUint::from_native_word(value);
+        for (const unsigned char *group = begin + head; group < end; group += 4) {
+            const auto digits = static_cast<BigUint::DigitType>(1'000 * (group[0] - '0') + 100 * (group[1] - '0') + 10 * (group[2] - '0') + (group[3] - '0'));
+            number.multiply_me_by(BigUint::DigitType{10'000});
+            number.add_me(digits);
+        }
+        return number;
+    }
+
+    // Every non blank line holds a number followed by its prime factors, separated by spaces or tabs
+    ParsedChunk parse_chunk(const std::span<const unsigned char> text) {
+        ParsedChunk chunk;
+        const unsigned char *position = text.data();
+        const unsigned char *const end = position + text.size();
+        while (position < end) {
+            const unsigned char *const lineEnd = std::find(position, end, '\n');
+            chunk.lines++;
+            std::vector<BigUint> numbers;
+            while (position < lineEnd) {
+                if (*position == ' ' || *position == '\t' || *position == '\r') {
+                    position++;
+                    continue;
+                }
+                if (!is_digit(*position)) {
+                    chunk.error = {chunk.lines, std::string("unexpected character '") + static_cast<char>(*position) + "'"};
+                    return chunk;
+                }
+                const unsigned char *const begin = position;
+                while (position < lineEnd && is_digit(*position)) {
+                    position++;
+                }
+                numbers.push_back(parse_decimal(begin, position));
+            }
+            position = lineEnd == end ? end : lineEnd + 1;
+
+            if (!numbers.empty()) {
+                BigUint number = std::move(numbers.front());
+                numbers.erase(numbers.begin());
+                chunk.entries.emplace_back(std::move(number), std::move(numbers));
+            }
+        }
+        return chunk;
+    }
+}
+
+FactorTable FactorTable::from_text_file(const std::filesystem::path &path, const std::size_t threads) {
+    const MappedFile file(path);
+    const auto text = file.bytes();
+
+    // chunks start right after a line break, so every line belongs to exactly one chunk
+    const std::size_t chunkCount = std::clamp<std::size_t>(text.size() / MIN_CHUNK_BYTES, 1, std::max<std::size_t>(1, threads));
+    std::vector<std::size_t> bounds{0};
+    for (std::size_t chunk = 1; chunk < chunkCount; chunk++) {
+        const auto lineBreak = std::find(text.begin() + static_cast<std::ptrdiff_t>(std::max(bounds.back(), text.size() / chunkCount * chunk)), text.end(), '\n');
+        bounds.push_back(lineBreak == text.end() ? text.size() : static_cast<std::size_t>(lineBreak - text.begin()) + 1);
+    }
+    bounds.push_back(text.size());
+
+    std::vector<ParsedChunk> chunks(chunkCount);
+    {
+        std::vector<std::thread> workers;
+        for (std::size_t chunk = 1; chunk < chunkCount; chunk++) {
+            workers.emplace_back([&chunks, &bounds, text, chunk] { chunks[chunk] = parse_chunk(text.subspan(bounds[chunk], bounds[chunk + 1] - bounds[chunk])); });
+        }
+        chunks[0] = parse_chunk(text.subspan(0, bounds[1]));
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    FactorTable factor_table;
+    std::size_t line_counter = 0;
+    for (auto &chunk : chunks) {
+        if (chunk.error) {
+            throw std::runtime_error("Could not parse line " + std::to_string(line_counter + chunk.error->first) + " of " + path.string() + ": " + chunk.error->second);
+        }
+        line_counter += chunk.lines;
+        for (const auto &[number, factors] : chunk.entries) {
+            factor_table.insert(number, factors);
+        }
+        chunk.entries = {};
+    }
+    return factor_table;
+}
+
+void FactorTable::write_text_file(const std::filesystem::path &path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Could not open file " + path.string());
+    }
+
+    bool first = true;
+    for_each([&out, &first](const BigUint &number, const std::vector<BigUint> &factors) {
+        out << (first ? "" : "\n") << number;
+        for (const auto &factor : factors) {
+            out << ' ' << factor;
+        }
+        first = false;
+    });
+}
+
+void FactorTable::add_range(const uint64_t low, const uint64_t high) {
+    if (low >= high) {
+        return;
+    }
+    if (!smallestFactors_.empty() && low != denseLow_ + smallestFactors_.size()) {
+        throw std::runtime_error("range " + std::to_string(low) + " does not continue the dense factor table");
+    }
+    if (smallestFactors_.empty()) {
+        denseLow_ = low;
+    }
+
+    const auto factors = sieve::smallest_prime_factors(low, high);
+    smallestFactors_.reserve(smallestFactors_.size() + factors.size());
+    for (uint64_t number = low; number < high; number++) {
+        const uint64_t factor = factors[number - low];
+        smallestFactors_.push_back(factor == number ? 0 : static_cast<uint32_t>(factor));
+    }
+}
+
+bool FactorTable::insert(const BigUint &number, const std::vector<BigUint> &factors) {
+    if (contains(number)) {
+        return false;
+    }
+
+    // the next number of the dense run, or the first one of an empty table
+    if (const auto word = number.as_native_word(); word && *word >= 2) {
+        if (smallestFactors_.empty()) {
+            denseLow_ = *word;
+        }
+        if (*word == denseLow_ + smallestFactors_.size()) {
+            const auto smallest = std::ranges::min_element(factors);
+            smallestFactors_.push_back(smallest == factors.end() ? 0 : static_cast<uint32_t>(*smallest->as_native_word()));
+            return true;
+        }
+    }
+
+    if (2 * (sparseSize_ + 1) > slots_.size()) {
+        grow();
+    }
+    Slot &slot = slots_[find_slot(number)];
+    slot.number = number;
+    slot.first = static_cast<uint32_t>(factors_.size());
+    slot.count = static_cast<uint32_t>(factors.size());
+    slot.used = true;
+    factors_.insert(factors_.end(), factors.begin(), factors.end());
+    sparseSize_++;
+    return true;
+}
+
+std::optional<std::vector<BigUint>> FactorTable::find(const BigUint &number) const {
+    if (dense_index(number)) {
+        return dense_factors(*number.as_native_word());
+    }
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    const Slot &slot = slots_[find_slot(number)];
+    if (!slot.used) {
+        return std::nullopt;
+    }
+    return sparse_factors(slot);
+}
+
+bool FactorTable::contains(const BigUint &number) const {
+    return dense_index(number) || (!slots_.empty() && slots_[find_slot(number)].used);
+}
+
+std::optional<BigUint> FactorTable::smallest() const {
+    std::optional<BigUint> result;
+    if (!smallestFactors_.empty()) {
+        result = BigUint::from_native_word(denseLow_);
+    }
+    for (const auto &slot : slots_) {
+        if (slot.used && (!result || slot.number < *result)) {
+            result = slot.number;
+        }
+    }
+    return result;
+}
+
+std::optional<BigUint> FactorTable::largest() const {
+    std::optional<BigUint> result;
+    if (!smallestFactors_.empty()) {
+        result = BigUint::from_native_word(denseLow_ + smallestFactors_.size() - 1);
+    }
+    for (const auto &slot : slots_) {
+        if (slot.used && (!result || slot.number > *result)) {
+            result = slot.number;
+        }
+    }
+    return result;
+}
+
+std::optional<uint64_t> FactorTable::dense_index(const BigUint &number) const {
+    const auto word = number.as_native_word();
+    if (!word || *word < denseLow_ || *word - denseLow_ >= smallestFactors_.size()) {
+        return std::nullopt;
+    }
+    return *word - denseLow_;
+}
+
+std::vector<BigUint> FactorTable::dense_factors(const uint64_t number) const {
+    return factors_from_smallest(smallestFactors_, denseLow_, number);
+}
+
+// Walks down the smallest prime factors
+std::vector<BigUint> FactorTable::factors_from_smallest(const std::span<const uint32_t> smallestFactors, const uint64_t low, const uint64_t number) {
+    if (smallestFactors[number - low] == 0) {
+        return {};
+    }
+
+    std::vector<BigUint> factors;
+    uint64_t rest = number;
+    while (rest > 1) {
+        if (rest < low) {
+            for (const auto factor : word::factor(rest)) {
+                factors.push_back(BigUint::from_native_word(factor));
+            }
+            break;
+        }
+        const uint32_t smallest = smallestFactors[rest - low];
+        const uint64_t factor = smallest == 0 ? rest : smallest;
+        factors.push_back(BigUint::from_native_word(factor));
+        rest /= factor;
+    }
+    return factors;
+}
+
+std::vector<BigUint> FactorTable::sparse_factors(const Slot &slot) const {
+    return {factors_.begin() + slot.first, factors_.begin() + slot.first + slot.count};
+}
+
+std::vector<std::size_t> FactorTable::sparse_order() const {
+    std::vector<std::size_t> order;
+    order.reserve(sparseSize_);
+    for (std::size_t slot = 0; slot < slots_.size(); slot++) {
+        if (slots_[slot].used) {
+            order.push_back(slot);
+        }
+    }
+    std::ranges::sort(order, [this](const std::size_t lhs, const std::size_t rhs) { return slots_[lhs].number < slots_[rhs].number; });
+    return order;
+}
+
+// Linear probing, the slot holding the number or the empty one where it would go
+std::size_t FactorTable::find_slot(const BigUint &number) const {
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t slot = std::hash<BigUint>{}(number) & mask;; slot = (slot + 1) & mask) {
+        if (!slots_[slot].used || slots_[slot].number == number) {
+            return slot;
+        }
+    }
+}
+
+void FactorTable::grow() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(std::max(INITIAL_SLOTS, 2 * old.size()), Slot{});
+    for (auto &slot : old) {
+        if (slot.used) {
+            slots_[find_slot(slot.number)] = std::move(slot);
+        }
+    }
+}
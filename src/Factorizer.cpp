@@ -0,0 +1,237 @@
+#include "Factorizer.h"
+#include "Ecm.h"
+#include "PollardRho.h"
+#include "Primality.h"
+#include "Sieve.h"
+#include "Siqs.h"
+#include "WordArithmetic.h"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace factor
+{
+    namespace {
+        // curves per ECM round when progress is recorded, at least one per thread
+        constexpr std::size_t ECM_ROUND_CURVES = 8;
+    }
+
+    Factorizer::Factorizer(FactorizerOptions options, Lookup lookup, EcmProgress progress)
+        : options_(options), lookup_(std::move(lookup)), progress_(std::move(progress)) {
+        if (options_.trial_division_bound > 2) {
+            primes_ = sieve::primes_below(options_.trial_division_bound);
+        }
+        for (std::size_t begin = 0; begin < primes_.size();) {
+            PrimeGroup group{1, begin, begin};
+            while (group.end < primes_.size() && group.product < BigUint::WORD_DIVISOR_BOUND / primes_[group.end]) {
+                group.product *= primes_[group.end++];
+            }
+            groups_.push_back(group);
+            begin = group.end;
+        }
+    }
+
+    std::vector<BigUint> Factorizer::factor(const BigUint &number) const {
+        std::vector<BigUint> factors;
+        if (number > BigUint::ONE) {
+            factor_into(number, factors);
+        }
+        std::ranges::sort(factors);
+        return factors;
+    }
+
+    std::vector<std::vector<BigUint>> Factorizer::factor_all(const std::span<const BigUint> numbers, std::size_t threads, const Emit &emit) const {
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<std::size_t> indices;
+        };
+
+        threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(numbers.size(), 1));
+        std::vector<WorkQueue> queues(threads);
+        for (std::size_t thread = 0; thread < threads; thread++) {
+            for (std::size_t index = thread * numbers.size() / threads; index < (thread + 1) * numbers.size() / threads; index++) {
+                queues[thread].indices.push_back(index);
+            }
+        }
+
+        // own queue from the front, the others from the back so that owner and thief rarely meet
+        const auto next_index = [&queues, threads](const std::size_t thread) -> std::optional<std::size_t> {
+            for (std::size_t offset = 0; offset < threads; offset++) {
+                auto &queue = queues[(thread + offset) % threads];
+                const std::lock_guard lock(queue.mutex);
+                if (queue.indices.empty()) {
+                    continue;
+                }
+                std::size_t index;
+                if (offset == 0) {
+                    index = queue.indices.front();
+                    queue.indices.pop_front();
+                }
+                else {
+                    index = queue.indices.back();
+                    queue.indices.pop_back();
+                }
+                return index;
+            }
+            return std::nullopt;
+        };
+
+        std::vector<std::optional<std::vector<BigUint>>> results(numbers.size());
+        std::vector<bool> done(numbers.size(), false);
+        std::size_t emitted = 0;
+        std::exception_ptr failure;
+        std::mutex sinkMutex;
+
+        const auto worker = [&](const std::size_t thread) {
+            while (const auto index = next_index(thread)) {
+                std::optional<std::vector<BigUint>> factors;
+                try {
+                    factors = factor(numbers[*index]);
+                } catch (...) {
+                    const std::lock_guard lock(sinkMutex);
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+
+                const std::lock_guard lock(sinkMutex);
+                results[*index] = std::move(factors);
+                done[*index] = true;
+                for (; emitted < numbers.size() && done[emitted]; emitted++) {
+                    if (emit) {
+                        emit(emitted, results[emitted]);
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (std::size_t thread = 1; thread < threads; thread++) {
+            workers.emplace_back(worker, thread);
+        }
+        worker(0);
+        for (auto &thread : workers) {
+            thread.join();
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        std::vector<std::vector<BigUint>> factorizations;
+        factorizations.reserve(results.size());
+        for (auto &factors : results) {
+            factorizations.push_back(std::move(*factors));
+        }
+        return factorizations;
+    }
+
+    void Factorizer::factor_into(BigUint number, std::vector<BigUint> &factors) const {
+        if (number == BigUint::ONE) {
+            return;
+        }
+
+        if (lookup_) {
+            if (const auto known = lookup_(number)) {
+                if (known->empty()) {
+                    factors.push_back(std::move(number));
+                }
+                factors.insert(factors.end(), known->begin(), known->end());
+                return;
+            }
+        }
+
+        const std::size_t found = factors.size();
+        divide_small_primes(number, factors);
+        if (factors.size() != found) {
+            // the cofactor may be in the table
+            factor_into(std::move(number), factors);
+            return;
+        }
+
+        if (const auto word = number.as_native_word()) {
+            for (const auto factor : word::factor(*word)) {
+                factors.push_back(BigUint::from_native_word(factor));
+            }
+            return;
+        }
+
+        if (primality::is_prime(number)) {
+            factors.push_back(std::move(number));
+            return;
+        }
+
+        if (const auto power = number.is_perfect_power()) {
+            std::vector<BigUint> baseFactors;
+            factor_into(power->first, baseFactors);
+            for (uint32_t ii = 0; ii < power->second; ii++) {
+                factors.insert(factors.end(), baseFactors.begin(), baseFactors.end());
+            }
+            return;
+        }
+
+        const auto divisor = find_divisor(number);
+        if (!divisor) {
+            throw std::runtime_error("could not factor " + number.to_base10_string());
+        }
+        const BigUint cofactor = number / *divisor;
+        factor_into(*divisor, factors);
+        factor_into(cofactor, factors);
+    }
+
+    // One remainder per group of primes, only the primes of a group whose remainder they divide cost a division
+    void Factorizer::divide_small_primes(BigUint &number, std::vector<BigUint> &factors) const {
+        for (const auto &group : groups_) {
+            const uint64_t remainder = number.remainder_by_word(group.product);
+            for (std::size_t ii = group.begin; ii < group.end; ii++) {
+                const uint32_t prime = primes_[ii];
+                if (remainder % prime != 0) {
+                    continue;
+                }
+                const BigUint divisor(prime);
+                while (true) {
+                    auto [quotient, rest] = number.divide_by(divisor);
+                    if (rest != BigUint::ZERO) {
+                        break;
+                    }
+                    number = std::move(quotient);
+                    factors.push_back(divisor);
+                }
+            }
+            if (number == BigUint::ONE) {
+                return;
+            }
+        }
+    }
+
+    std::optional<BigUint> Factorizer::find_divisor(const BigUint &number) const {
+        if (options_.rho_iterations > 0) {
+            if (auto divisor = pollard_rho_brent(number, options_.threads, options_.rho_iterations)) {
+                return divisor;
+            }
+        }
+        if (options_.ecm_curves > 0) {
+            std::size_t done = progress_.done ? std::min(progress_.done(number, options_.ecm_b1), options_.ecm_curves) : 0;
+            const std::size_t round = progress_.record ? std::max(ECM_ROUND_CURVES, options_.threads) : options_.ecm_curves;
+            while (done < options_.ecm_curves) {
+                const std::size_t end = std::min(options_.ecm_curves, done + round);
+                if (auto divisor = ecm(number, options_.ecm_b1, options_.ecm_b2, end, options_.threads, done)) {
+                    return divisor;
+                }
+                done = end;
+                if (progress_.record) {
+                    progress_.record(number, options_.ecm_b1, done);
+                }
+            }
+        }
+        if (options_.siqs_max_digits > 0 && number.to_base10_string().size() <= options_.siqs_max_digits) {
+            if (auto divisor = siqs(number, options_.threads)) {
+                return divisor;
+            }
+        }
+        return std::nullopt;
+    }
+} // end namespace factor
@@ -0,0 +1,270 @@
+#include "MappedFactorTable.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    constexpr char MAGIC[8] = {'F', 'A', 'C', 'T', 'T', 'A', 'B', '\0'};
+    constexpr std::size_t HEADER_SIZE = 64;
+
+    using Bytes = std::vector<unsigned char>;
+
+    void put_word(Bytes &out, const uint64_t value, const int bytes) {
+        for (int ii = 0; ii < bytes; ii++) {
+            out.push_back(static_cast<unsigned char>(value >> (8 * ii)));
+        }
+    }
+
+    uint64_t get_word(const unsigned char *in, const int bytes) {
+        uint64_t value = 0;
+        for (int ii = 0; ii < bytes; ii++) {
+            value |= static_cast<uint64_t>(in[ii]) << (8 * ii);
+        }
+        return value;
+    }
+
+    // Seven bits per byte, the high bit marks that more bytes follow
+    void put_varint(Bytes &out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    // Little endian bytes without leading zeros, nothing for zero
+    Bytes number_bytes(const BigUint &number) {
+        Bytes bytes;
+        for (const auto digit : number.get_digits()) {
+            put_word(bytes, digit, 2);
+        }
+        while (!bytes.empty() && bytes.back() == 0) {
+            bytes.pop_back();
+        }
+        return bytes;
+    }
+
+    void put_number(Bytes &out, const BigUint &number) {
+        const auto bytes = number_bytes(number);
+        put_varint(out, bytes.size());
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    // Bounds checked cursor over the records section, a corrupt file throws instead of reading past the mapping
+    class Reader {
+    public:
+        Reader(const std::span<const unsigned char> records, const uint64_t offset) : records_(records), position_(offset) {
+            if (offset >= records.size()) {
+                throw std::runtime_error("factor table record offset " + std::to_string(offset) + " is out of the file");
+            }
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const unsigned char byte = take(1).front();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("factor table varint is too long");
+        }
+
+        std::span<const unsigned char> take(const uint64_t count) {
+            if (count > records_.size() - position_) {
+                throw std::runtime_error("factor table record runs past the end of the file");
+            }
+            const auto bytes = records_.subspan(position_, count);
+            position_ += count;
+            return bytes;
+        }
+
+        std::span<const unsigned char> number_bytes() { return take(varint()); }
+
+        BigUint number() {
+            const auto bytes = number_bytes();
+            BigUint::Digits digits(std::max<std::size_t>(1, (bytes.size() + 1) / 2), 0);
+            for (std::size_t ii = 0; ii < bytes.size(); ii++) {
+                digits[ii / 2] |= static_cast<BigUint::DigitType>(bytes[ii] << (8 * (ii % 2)));
+            }
+            BigUint result;
+            result.set_digits(digits);
+            return result;
+        }
+
+    private:
+        std::span<const unsigned char> records_;
+        uint64_t position_;
+    };
+
+    // Numbers compare by length and then from the most significant byte down
+    std::strong_ordering compare_number_bytes(const std::span<const unsigned char> lhs, const std::span<const unsigned char> rhs) {
+        if (lhs.size() != rhs.size()) {
+            return lhs.size() <=> rhs.size();
+        }
+        return std::lexicographical_compare_three_way(lhs.rbegin(), lhs.rend(), rhs.rbegin(), rhs.rend());
+    }
+}
+
+MappedFactorTable::MappedFactorTable(const std::filesystem::path &path)
+    : file_(path) {
+    if constexpr (std::endian::native != std::endian::little) {
+        throw std::runtime_error("binary factor tables can only be mapped on little endian machines");
+    }
+
+    const auto bytes = file_.bytes();
+    const unsigned char *data = bytes.data();
+    if (bytes.size() < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error(path.string() + " is not a binary factor table");
+    }
+    if (const auto version = get_word(data + 8, 4); version != VERSION) {
+        throw std::runtime_error(path.string() + " has unsupported factor table version " + std::to_string(version));
+    }
+
+    const std::size_t size = bytes.size();
+    denseLow_ = get_word(data + 16, 8);
+    const uint64_t denseCount = get_word(data + 24, 8);
+    const uint64_t sparseCount = get_word(data + 32, 8);
+    const uint64_t denseOffset = get_word(data + 40, 8);
+    const uint64_t indexOffset = get_word(data + 48, 8);
+    const uint64_t recordsOffset = get_word(data + 56, 8);
+    if (denseOffset % alignof(uint32_t) != 0 || indexOffset % alignof(uint64_t) != 0
+        || denseOffset > size || denseCount > (size - denseOffset) / sizeof(uint32_t)
+        || indexOffset > size || sparseCount > (size - indexOffset) / sizeof(uint64_t)
+        || recordsOffset > size) {
+        throw std::runtime_error(path.string() + " has a corrupt factor table header");
+    }
+
+    smallestFactors_ = {reinterpret_cast<const uint32_t *>(data + denseOffset), denseCount};
+    index_ = {reinterpret_cast<const uint64_t *>(data + indexOffset), sparseCount};
+    records_ = bytes.subspan(recordsOffset);
+}
+
+std::optional<std::vector<BigUint>> MappedFactorTable::find(const BigUint &number) const {
+    if (const auto word = number.as_native_word(); word && *word >= denseLow_ && *word - denseLow_ < smallestFactors_.size()) {
+        return FactorTable::factors_from_smallest(smallestFactors_, denseLow_, *word);
+    }
+    if (const auto position = find_position(number)) {
+        return factors(*position);
+    }
+    return std::nullopt;
+}
+
+bool MappedFactorTable::contains(const BigUint &number) const {
+    if (const auto word = number.as_native_word(); word && *word >= denseLow_ && *word - denseLow_ < smallestFactors_.size()) {
+        return true;
+    }
+    return find_position(number).has_value();
+}
+
+BigUint MappedFactorTable::key(const std::size_t position) const {
+    return Reader(records_, index_[position]).number();
+}
+
+std::vector<BigUint> MappedFactorTable::factors(const std::size_t position) const {
+    Reader reader(records_, index_[position]);
+    (void) reader.number_bytes();
+    const uint64_t count = reader.varint();
+    std::vector<BigUint> factors;
+    factors.reserve(std::min<uint64_t>(count, records_.size()));
+    for (uint64_t ii = 0; ii < count; ii++) {
+        factors.push_back(reader.number());
+    }
+    return factors;
+}
+
+// Binary search comparing the raw number bytes of the records, nothing is decoded on the way
+std::optional<std::size_t> MappedFactorTable::find_position(const BigUint &number) const {
+    const auto bytes = number_bytes(number);
+    std::size_t low = 0;
+    std::size_t high = index_.size();
+    while (low < high) {
+        const std::size_t middle = low + (high - low) / 2;
+        const auto order = compare_number_bytes(Reader(records_, index_[middle]).number_bytes(), bytes);
+        if (order == 0) {
+            return middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return std::nullopt;
+}
+
+void write_binary_factor_table(const FactorTable &table, const std::filesystem::path &path) {
+    Bytes records;
+    Bytes index;
+    uint64_t sparseCount = 0;
+    table.for_each_sparse([&](const BigUint &number, const std::vector<BigUint> &factors) {
+        put_word(index, records.size(), 8);
+        put_number(records, number);
+        put_varint(records, factors.size());
+        for (const auto &factor : factors) {
+            put_number(records, factor);
+        }
+        sparseCount++;
+    });
+
+    const auto smallestFactors = table.smallest_factors();
+    Bytes dense;
+    dense.reserve(sizeof(uint32_t) * smallestFactors.size() + sizeof(uint64_t));
+    for (const auto factor : smallestFactors) {
+        put_word(dense, factor, 4);
+    }
+    // the index starts on an eight byte boundary
+    dense.resize((HEADER_SIZE + dense.size() + 7) / 8 * 8 - HEADER_SIZE, 0);
+
+    Bytes header(MAGIC, MAGIC + sizeof(MAGIC));
+    put_word(header, MappedFactorTable::VERSION, 4);
+    put_word(header, 0, 4);
+    put_word(header, table.dense_low(), 8);
+    put_word(header, smallestFactors.size(), 8);
+    put_word(header, sparseCount, 8);
+    put_word(header, HEADER_SIZE, 8);
+    put_word(header, HEADER_SIZE + dense.size(), 8);
+    put_word(header, HEADER_SIZE + dense.size() + index.size(), 8);
+
+    // readers that still map the old file keep their pages, the new one appears at once
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Could not open file " + temporary.string());
+        }
+        for (const Bytes *section : {&header, &dense, &index, &records}) {
+            out.write(reinterpret_cast<const char *>(section->data()), static_cast<std::streamsize>(section->size()));
+        }
+        if (!out) {
+            throw std::runtime_error("Could not write file " + temporary.string());
+        }
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+void convert_text_to_binary(const std::filesystem::path &text, const std::filesystem::path &binary) {
+    write_binary_factor_table(FactorTable::from_text_file(text), binary);
+}
+
+void convert_binary_to_text(const std::filesystem::path &binary, const std::filesystem::path &text) {
+    const MappedFactorTable table(binary);
+    std::ofstream out(text);
+    if (!out) {
+        throw std::runtime_error("Could not open file " + text.string());
+    }
+
+    bool first = true;
+    table.for_each([&out, &first](const BigUint &number, const std::vector<BigUint> &factors) {
+        out << (first ? "" : "\n") << number;
+        for (const auto &factor : factors) {
+            out << ' ' << factor;
+        }
+        first = false;
+    });
+}
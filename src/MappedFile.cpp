@@ -0,0 +1,80 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+    file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize{};
+    if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &fileSize)) {
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+        }
+        file_ = nullptr;
+        throw std::runtime_error("Could not open file " + path.string());
+    }
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data_ = mapping_ ? static_cast<const unsigned char *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    struct stat status{};
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw std::runtime_error("Could not open file " + path.string());
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ == 0) {
+        close(fd);
+        return;
+    }
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    data_ = data == MAP_FAILED ? nullptr : static_cast<const unsigned char *>(data);
+    close(fd);
+#endif
+    if (data_ == nullptr) {
+        unmap();
+        throw std::runtime_error("Could not map file " + path.string());
+    }
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+void MappedFile::unmap() {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != nullptr) {
+        CloseHandle(file_);
+    }
+    file_ = nullptr;
+    mapping_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        munmap(const_cast<unsigned char *>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
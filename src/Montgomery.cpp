@@ -0,0 +1,148 @@
+#include "Montgomery.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+Montgomery::Montgomery(const BigUint &mod)
+    : mod_(mod) {
+    if (mod.is_even() || mod == BigUint::ONE) {
+        throw std::runtime_error("Montgomery modulus must be odd and greater than one");
+    }
+
+    modWords_ = to_words(mod);
+
+    // Newton iteration, every step doubles the number of correct low bits
+    const Word low = modWords_[0];
+    Word inverse = low;
+    for (int ii = 0; ii < 5; ii++) {
+        inverse *= 2 - low * inverse;
+    }
+    inverse_ = 0 - inverse;
+
+    const std::size_t bits = std::numeric_limits<Word>::digits * modWords_.size();
+    one_ = BigUint::ONE.shift_left_bits(bits) % mod;
+    rSquared_ = BigUint::ONE.shift_left_bits(2 * bits) % mod;
+}
+
+BigUint Montgomery::to_montgomery(const BigUint &value) const {
+    return multiply(value % mod_, rSquared_);
+}
+
+BigUint Montgomery::from_montgomery(const BigUint &value) const {
+    return multiply(value, BigUint::ONE);
+}
+
+// Coarsely integrated operand scanning: interleaves the schoolbook product with the reduction
+// on 32-bit words, so the double length product is never stored
+BigUint Montgomery::multiply(const BigUint &lhs, const BigUint &rhs) const {
+    constexpr int wordBits = std::numeric_limits<Word>::digits;
+    const std::size_t n = modWords_.size();
+    const Words a = to_words(lhs);
+    const Words b = to_words(rhs);
+    Words t(n + 2, 0);
+
+    for (std::size_t ii = 0; ii < n; ii++) {
+        uint64_t carry = 0;
+        for (std::size_t jj = 0; jj < n; jj++) {
+            const uint64_t sum = t[jj] + static_cast<uint64_t>(a[jj]) * b[ii] + carry;
+            t[jj] = static_cast<Word>(sum);
+            carry = sum >> wordBits;
+        }
+        uint64_t sum = t[n] + carry;
+        t[n] = static_cast<Word>(sum);
+        t[n + 1] = static_cast<Word>(sum >> wordBits);
+
+        // add factor * mod so that the lowest word vanishes, then shift down by a word
+        const uint64_t factor = static_cast<Word>(t[0] * inverse_);
+        carry = (t[0] + factor * modWords_[0]) >> wordBits;
+        for (std::size_t jj = 1; jj < n; jj++) {
+            sum = t[jj] + factor * modWords_[jj] + carry;
+            t[jj - 1] = static_cast<Word>(sum);
+            carry = sum >> wordBits;
+        }
+        sum = t[n] + carry;
+        t[n - 1] = static_cast<Word>(sum);
+        t[n] = t[n + 1] + static_cast<Word>(sum >> wordBits);
+    }
+
+    BigUint::Digits digits(2 * (n + 1));
+    for (std::size_t ii = 0; ii <= n; ii++) {
+        digits[2 * ii] = static_cast<BigUint::DigitType>(t[ii]);
+        digits[2 * ii + 1] = static_cast<BigUint::DigitType>(t[ii] >> std::numeric_limits<BigUint::DigitType>::digits);
+    }
+    BigUint result;
+    result.set_digits(digits);
+    if (result >= mod_) {
+        result -= mod_;
+    }
+    return result;
+}
+
+BigUint Montgomery::square(const BigUint &value) const {
+    return multiply(value, value);
+}
+
+BigUint Montgomery::add(const BigUint &lhs, const BigUint &rhs) const {
+    BigUint sum = lhs + rhs;
+    if (sum >= mod_) {
+        sum -= mod_;
+    }
+    return sum;
+}
+
+BigUint Montgomery::subtract(const BigUint &lhs, const BigUint &rhs) const {
+    if (lhs >= rhs) {
+        return lhs - rhs;
+    }
+    return lhs + (mod_ - rhs);
+}
+
+BigUint Montgomery::half(const BigUint &value) const {
+    if (value.is_even()) {
+        return value.shift_right_bits(1);
+    }
+    return (value + mod_).shift_right_bits(1);
+}
+
+// Fixed window exponentiation, four exponent bits per multiplication
+BigUint Montgomery::pow(const BigUint &base, const BigUint &exponent) const {
+    constexpr std::size_t windowBits = 4;
+    std::array<BigUint, 1 << windowBits> powers;
+    powers[0] = one_;
+    for (std::size_t ii = 1; ii < powers.size(); ii++) {
+        powers[ii] = multiply(powers[ii - 1], base);
+    }
+
+    constexpr std::size_t digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+    const auto &digits = exponent.get_digits();
+    BigUint result = one_;
+    bool leading = true;
+    for (std::size_t window = (exponent.bit_length() + windowBits - 1) / windowBits; window-- > 0;) {
+        const std::size_t bit = window * windowBits;
+        const auto index = static_cast<std::size_t>((digits[bit / digitBits] >> (bit % digitBits)) & ((1U << windowBits) - 1));
+        if (!leading) {
+            for (std::size_t ii = 0; ii < windowBits; ii++) {
+                result = square(result);
+            }
+            if (index != 0) {
+                result = multiply(result, powers[index]);
+            }
+        }
+        else if (index != 0) {
+            result = powers[index];
+            leading = false;
+        }
+    }
+    return result;
+}
+
+Montgomery::Words Montgomery::to_words(const BigUint &value) const {
+    constexpr int digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+    const auto &digits = value.get_digits();
+    Words words(std::max(modWords_.size(), (digits.size() + 1) / 2), 0);
+    for (std::size_t ii = 0; ii < digits.size(); ii++) {
+        words[ii / 2] |= static_cast<Word>(digits[ii]) << (ii % 2 * digitBits);
+    }
+    return words;
+}
@@ -0,0 +1,114 @@
+#include "PollardRho.h"
+#include "Montgomery.h"
+#include "WordArithmetic.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace factor
+{
+    namespace {
+        constexpr uint64_t GCD_BATCH = 100;
+        constexpr uint32_t POLYNOMIALS_PER_THREAD = 4;
+
+        // One Brent walk with f(x) = x^2 + c, the constant and the start are in Montgomery form
+        std::optional<BigUint> brent_walk(const Montgomery &montgomery, const BigUint &c, const BigUint &start, const uint64_t max_iterations, const std::atomic<bool> &stop) {
+            const BigUint &number = montgomery.modulus();
+            const auto step = [&](const BigUint &value) { return montgomery.add(montgomery.square(value), c); };
+
+            BigUint y = start;
+            BigUint x;
+            BigUint saved;
+            BigUint product = montgomery.one();
+            BigUint divisor = BigUint::ONE;
+            uint64_t iterations = 0;
+            for (uint64_t length = 1; divisor == BigUint::ONE; length *= 2) {
+                x = y;
+                for (uint64_t ii = 0; ii < length; ii++) {
+                    y = step(y);
+                }
+                iterations += length;
+
+                for (uint64_t done = 0; done < length && divisor == BigUint::ONE; done += GCD_BATCH) {
+                    if (stop.load(std::memory_order_relaxed) || iterations > max_iterations) {
+                        return std::nullopt;
+                    }
+
+                    saved = y;
+                    const uint64_t batch = std::min(GCD_BATCH, length - done);
+                    for (uint64_t ii = 0; ii < batch; ii++) {
+                        y = step(y);
+                        product = montgomery.multiply(product, montgomery.subtract(x, y));
+                    }
+                    iterations += batch;
+                    // product is kept times R, which is coprime to the odd number and does not change the gcd
+                    divisor = BigUint::gcd(product, number);
+                }
+            }
+
+            if (divisor == number) {
+                // the batch overshot, retrace it one difference at a time
+                do {
+                    saved = step(saved);
+                    divisor = BigUint::gcd(montgomery.subtract(x, saved), number);
+                } while (divisor == BigUint::ONE);
+            }
+
+            if (divisor == number) {
+                return std::nullopt;
+            }
+            return divisor;
+        }
+    }
+
+    std::optional<BigUint> pollard_rho_brent(const BigUint &number, std::size_t threads, const uint64_t max_iterations) {
+        if (number < BigUint(4)) {
+            return std::nullopt;
+        }
+        if (number.is_even()) {
+            return BigUint::TWO;
+        }
+        if (const auto word = number.as_native_word()) {
+            if (word::is_prime(*word)) {
+                return std::nullopt;
+            }
+            return BigUint::from_native_word(word::pollard_rho(*word));
+        }
+
+        const Montgomery montgomery(number);
+        threads = std::max<std::size_t>(threads, 1);
+        std::atomic<bool> stop = false;
+        std::mutex mutex;
+        std::optional<BigUint> result;
+
+        const auto worker = [&](const std::size_t index) {
+            for (uint32_t polynomial = 0; polynomial < POLYNOMIALS_PER_THREAD && !stop.load(); polynomial++) {
+                const auto c = static_cast<BigUint::WideDigitType>(1 + index + polynomial * threads);
+                auto divisor = brent_walk(montgomery, montgomery.to_montgomery(BigUint(c)), montgomery.to_montgomery(BigUint(c + 1)), max_iterations, stop);
+                if (divisor) {
+                    const std::lock_guard lock(mutex);
+                    if (!result) {
+                        result = std::move(divisor);
+                    }
+                    stop = true;
+                }
+            }
+        };
+
+        if (threads == 1) {
+            worker(0);
+            return result;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (std::size_t index = 0; index < threads; index++) {
+            workers.emplace_back(worker, index);
+        }
+        for (auto &thread : workers) {
+            thread.join();
+        }
+        return result;
+    }
+} // end namespace factor
@@ -0,0 +1,216 @@
+#include "Primality.h"
+#include "Montgomery.h"
+#include "WordArithmetic.h"
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace primality
+{
+    namespace {
+        constexpr uint32_t TRIAL_DIVISION_BOUND = 4'096;
+
+        struct TrialDivisionTable {
+            std::vector<uint32_t> primes;
+            // product of primes[begin, end) for every group
+            struct Group {
+                uint64_t product;
+                std::size_t begin;
+                std::size_t end;
+            };
+            std::vector<Group> groups;
+            BigUint product = BigUint::ONE;
+        };
+
+        TrialDivisionTable build_trial_division_table() {
+            TrialDivisionTable table;
+            std::vector<bool> composite(TRIAL_DIVISION_BOUND, false);
+            for (uint32_t ii = 2; ii < TRIAL_DIVISION_BOUND; ii++) {
+                if (composite[ii]) {
+                    continue;
+                }
+                table.primes.push_back(ii);
+                for (uint32_t jj = ii * ii; jj < TRIAL_DIVISION_BOUND; jj += ii) {
+                    composite[jj] = true;
+                }
+            }
+
+            for (std::size_t ii = 0; ii < table.primes.size();) {
+                TrialDivisionTable::Group group{1, ii, ii};
+                while (group.end < table.primes.size() && group.product * table.primes[group.end] < BigUint::WORD_DIVISOR_BOUND) {
+                    group.product *= table.primes[group.end++];
+                }
+                table.product *= BigUint::from_native_word(group.product);
+                table.groups.push_back(group);
+                ii = group.end;
+            }
+            return table;
+        }
+
+        const TrialDivisionTable & trial_division_table() {
+            static const TrialDivisionTable table = build_trial_division_table();
+            return table;
+        }
+
+        // One big remainder by the product of all small primes, then one word remainder per group of primes
+        bool has_small_factor(const BigUint &number) {
+            const auto &table = trial_division_table();
+            const BigUint reduced = number > table.product ? number % table.product : number;
+            for (const auto &group : table.groups) {
+                const uint64_t remainder = reduced.remainder_by_word(group.product);
+                for (std::size_t ii = group.begin; ii < group.end; ii++) {
+                    if (remainder % table.primes[ii] == 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        bool is_perfect_square(const BigUint &number) {
+            // Quadratic residues filter out most non squares before the square root
+            constexpr std::array<BigUint::DigitType, 4> moduli{64, 63, 65, 11};
+            for (const auto mod : moduli) {
+                const auto residue = number % mod;
+                bool isResidue = false;
+                for (BigUint::DigitType ii = 0; ii < mod && !isResidue; ii++) {
+                    isResidue = ii * ii % mod == residue;
+                }
+                if (!isResidue) {
+                    return false;
+                }
+            }
+
+            const BigUint root = number.isqrt();
+            return root.square() == number;
+        }
+
+        bool strong_probable_prime(const Montgomery &montgomery, const BigUint &base) {
+            const BigUint &number = montgomery.modulus();
+            const BigUint numberMinusOne = number.minus_one();
+            const std::size_t shift = numberMinusOne.count_trailing_zeros();
+            const BigUint one = montgomery.one();
+            const BigUint minusOne = montgomery.subtract(BigUint::ZERO, one);
+
+            BigUint x = montgomery.pow(montgomery.to_montgomery(base), numberMinusOne.shift_right_bits(shift));
+            if (x == one || x == minusOne) {
+                return true;
+            }
+
+            for (std::size_t ii = 1; ii < shift; ii++) {
+                x = montgomery.square(x);
+                if (x == minusOne) {
+                    return true;
+                }
+                if (x == one) {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        // Signed small value in Montgomery form
+        BigUint to_montgomery(const Montgomery &montgomery, const int64_t value) {
+            const BigUint magnitude = montgomery.to_montgomery(BigUint::from_native_word(static_cast<uint64_t>(value < 0 ? -value : value)));
+            return value < 0 ? montgomery.subtract(BigUint::ZERO, magnitude) : magnitude;
+        }
+
+        // Jacobi symbol (d / number) for a small odd d and an odd number, through quadratic reciprocity
+        int jacobi(const int64_t d, const BigUint &number) {
+            const auto magnitude = static_cast<BigUint::DigitType>(d < 0 ? -d : d);
+            int result = word::jacobi(number % magnitude, magnitude);
+            const bool numberIs3Mod4 = number.get_least_significant_digit() % 4 == 3;
+            if (magnitude % 4 == 3 && numberIs3Mod4) {
+                result = -result;
+            }
+            if (d < 0 && numberIs3Mod4) {
+                result = -result;
+            }
+            return result;
+        }
+
+        // Strong Lucas test with Selfridge's parameters: the first D in 5, -7, 9, -11, ... with (D / n) = -1, P = 1, Q = (1 - D) / 4
+        bool strong_lucas_probable_prime(const Montgomery &montgomery) {
+            const BigUint &number = montgomery.modulus();
+            int64_t d = 5;
+            while (true) {
+                const int symbol = jacobi(d, number);
+                if (symbol == -1) {
+                    break;
+                }
+                if (symbol == 0) {
+                    return false;
+                }
+                d = d > 0 ? -(d + 2) : -d + 2;
+            }
+
+            const BigUint dMontgomery = to_montgomery(montgomery, d);
+            const BigUint q = to_montgomery(montgomery, (1 - d) / 4);
+
+            // number + 1 = odd 2^shift, U_k and V_k run over the bits of odd with the doubling formulas
+            const BigUint numberPlusOne = number.plus_one();
+            const std::size_t shift = numberPlusOne.count_trailing_zeros();
+            const BigUint odd = numberPlusOne.shift_right_bits(shift);
+            const auto &oddDigits = odd.get_digits();
+            constexpr std::size_t digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+
+            BigUint u = montgomery.one();
+            BigUint v = montgomery.one();
+            BigUint qk = q;
+            for (std::size_t bit = odd.bit_length() - 1; bit-- > 0;) {
+                // k -> 2k
+                u = montgomery.multiply(u, v);
+                v = montgomery.subtract(montgomery.square(v), montgomery.add(qk, qk));
+                qk = montgomery.square(qk);
+                if ((oddDigits[bit / digitBits] >> (bit % digitBits)) & 1) {
+                    // 2k -> 2k + 1
+                    BigUint nextU = montgomery.half(montgomery.add(u, v));
+                    v = montgomery.half(montgomery.add(montgomery.multiply(dMontgomery, u), v));
+                    u = std::move(nextU);
+                    qk = montgomery.multiply(qk, q);
+                }
+            }
+
+            if (u == BigUint::ZERO || v == BigUint::ZERO) {
+                return true;
+            }
+
+            for (std::size_t ii = 1; ii < shift; ii++) {
+                v = montgomery.subtract(montgomery.square(v), montgomery.add(qk, qk));
+                if (v == BigUint::ZERO) {
+                    return true;
+                }
+                qk = montgomery.square(qk);
+            }
+            return false;
+        }
+    }
+
+    bool is_divisible_by(const BigUint &number, const uint8_t divisor) {
+        if (divisor == 0) {
+            throw std::runtime_error("Division by zero is not allowed.");
+        }
+        return number % static_cast<BigUint::DigitType>(divisor) == 0;
+    }
+
+    bool is_divisible_by(const BigUint &number, const BigUint &divisor) {
+        return number % divisor == BigUint::ZERO;
+    }
+
+    // Word sized numbers get a deterministic Miller-Rabin, larger ones trial division followed by Baillie-PSW
+    bool is_prime(const BigUint &number) {
+        if (const auto value = number.as_native_word()) {
+            return word::is_prime(*value);
+        }
+
+        if (has_small_factor(number)) {
+            return false;
+        }
+
+        const Montgomery montgomery(number);
+        return strong_probable_prime(montgomery, BigUint::TWO)
+            && !is_perfect_square(number)
+            && strong_lucas_probable_prime(montgomery);
+    }
+} // end namespace primality
@@ -0,0 +1,258 @@
+#include "Sieve.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <thread>
+
+namespace sieve
+{
+    namespace {
+        constexpr uint64_t WHEEL = 30;
+        constexpr std::array<uint64_t, 8> WHEEL_RESIDUES{1, 7, 11, 13, 17, 19, 23, 29};
+        // Bytes per segment, 32 KiB covers almost a million numbers
+        constexpr uint64_t SEGMENT_BYTES = 32 * 1'024;
+        constexpr uint32_t SIMPLE_SIEVE_LIMIT = 1 << 16;
+
+        constexpr std::array<uint8_t, WHEEL> build_residue_bits() {
+            std::array<uint8_t, WHEEL> bits{};
+            for (std::size_t ii = 0; ii < WHEEL_RESIDUES.size(); ii++) {
+                bits[WHEEL_RESIDUES[ii]] = static_cast<uint8_t>(1U << ii);
+            }
+            return bits;
+        }
+        // bit of n % 30 in its byte, zero for residues sharing a factor with 30
+        constexpr std::array<uint8_t, WHEEL> RESIDUE_BITS = build_residue_bits();
+
+        std::vector<uint32_t> simple_sieve(const uint32_t limit) {
+            std::vector<bool> composite(limit, false);
+            std::vector<uint32_t> primes;
+            for (uint32_t ii = 2; ii < limit; ii++) {
+                if (composite[ii]) {
+                    continue;
+                }
+                primes.push_back(ii);
+                for (uint64_t jj = static_cast<uint64_t>(ii) * ii; jj < limit; jj += ii) {
+                    composite[jj] = true;
+                }
+            }
+            return primes;
+        }
+
+        // Primes from 7 up to sqrt(high), the ones that cross off composites on the wheel
+        std::vector<uint32_t> sieving_primes(const uint64_t high) {
+            const uint64_t limit = isqrt(high) + 1;
+            std::vector<uint32_t> primes;
+            if (limit <= SIMPLE_SIEVE_LIMIT) {
+                primes = simple_sieve(static_cast<uint32_t>(limit));
+            }
+            else {
+                primes = primes_below(static_cast<uint32_t>(std::min<uint64_t>(limit, UINT32_MAX)));
+            }
+            std::erase_if(primes, [](const uint32_t prime) { return prime < 7; });
+            return primes;
+        }
+
+        // Sieves the wheel bytes [firstByte, lastByte) and hands every prime in [low, high) to output
+        template <typename Output>
+        void sieve_bytes(const uint64_t firstByte, const uint64_t lastByte, const uint64_t low, const uint64_t high,
+                         const std::vector<uint32_t> &primes, Output &&output) {
+            // next byte and bit mask of the multiples p q with q = WHEEL_RESIDUES[jj] (mod 30), q >= p
+            std::vector<uint64_t> nextByte(primes.size() * WHEEL_RESIDUES.size());
+            std::vector<uint8_t> masks(nextByte.size());
+            const uint64_t firstNumber = firstByte * WHEEL;
+            for (std::size_t ii = 0; ii < primes.size(); ii++) {
+                const uint64_t prime = primes[ii];
+                const uint64_t firstFactor = std::max(prime, (firstNumber + prime - 1) / prime);
+                for (std::size_t jj = 0; jj < WHEEL_RESIDUES.size(); jj++) {
+                    const uint64_t factor = firstFactor + (WHEEL_RESIDUES[jj] + WHEEL - firstFactor % WHEEL) % WHEEL;
+                    const uint64_t multiple = prime * factor;
+                    nextByte[ii * WHEEL_RESIDUES.size() + jj] = multiple / WHEEL;
+                    masks[ii * WHEEL_RESIDUES.size() + jj] = static_cast<uint8_t>(~RESIDUE_BITS[multiple % WHEEL]);
+                }
+            }
+
+            std::vector<uint8_t> segment(SEGMENT_BYTES);
+            for (uint64_t segmentStart = firstByte; segmentStart < lastByte; segmentStart += SEGMENT_BYTES) {
+                const uint64_t segmentEnd = std::min(segmentStart + SEGMENT_BYTES, lastByte);
+                std::fill(segment.begin(), segment.end(), 0xFF);
+                if (segmentStart == 0) {
+                    segment[0] &= static_cast<uint8_t>(~RESIDUE_BITS[1]);
+                }
+
+                for (std::size_t ii = 0; ii < primes.size(); ii++) {
+                    const uint64_t prime = primes[ii];
+                    for (std::size_t jj = ii * WHEEL_RESIDUES.size(); jj < (ii + 1) * WHEEL_RESIDUES.size(); jj++) {
+                        uint64_t byte = nextByte[jj];
+                        const uint8_t mask = masks[jj];
+                        for (; byte < segmentEnd; byte += prime) {
+                            segment[byte - segmentStart] &= mask;
+                        }
+                        nextByte[jj] = byte;
+                    }
+                }
+
+                for (uint64_t byte = segmentStart; byte < segmentEnd; byte++) {
+                    for (auto bits = static_cast<unsigned>(segment[byte - segmentStart]); bits != 0; bits &= bits - 1) {
+                        const uint64_t number = byte * WHEEL + WHEEL_RESIDUES[std::countr_zero(bits)];
+                        if (number >= low && number < high) {
+                            output(number);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Splits the wheel bytes of [low, high) in one chunk per thread, make_output(chunk) gives each chunk its own sink
+        template <typename MakeOutput>
+        void sieve_range(const uint64_t low, const uint64_t high, std::size_t threads, MakeOutput &&make_output) {
+            for (const uint64_t prime : {2, 3, 5}) {
+                if (prime >= low && prime < high) {
+                    make_output(0)(prime);
+                }
+            }
+            if (high <= 7 || low >= high) {
+                return;
+            }
+
+            const auto primes = sieving_primes(high - 1);
+            const uint64_t firstByte = low / WHEEL;
+            const uint64_t lastByte = high / WHEEL + 1;
+            const uint64_t bytes = lastByte - firstByte;
+            threads = std::clamp<std::size_t>(threads, 1, static_cast<std::size_t>((bytes + SEGMENT_BYTES - 1) / SEGMENT_BYTES));
+            const uint64_t chunkBytes = (bytes + threads - 1) / threads;
+            if (threads == 1) {
+                sieve_bytes(firstByte, lastByte, low, high, primes, make_output(0));
+                return;
+            }
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads);
+            for (std::size_t ii = 0; ii < threads; ii++) {
+                const uint64_t chunkStart = std::min(firstByte + ii * chunkBytes, lastByte);
+                const uint64_t chunkEnd = std::min(chunkStart + chunkBytes, lastByte);
+                workers.emplace_back([&, ii, chunkStart, chunkEnd] {
+                    sieve_bytes(chunkStart, chunkEnd, low, high, primes, make_output(ii));
+                });
+            }
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        }
+
+        template <typename Prime>
+        std::vector<Prime> collect_primes(const uint64_t low, const uint64_t high, const std::size_t threads) {
+            std::vector<std::vector<Prime>> chunks(std::max<std::size_t>(threads, 1));
+            sieve_range(low, high, threads, [&chunks](const std::size_t chunk) {
+                return [&primes = chunks[chunk]](const uint64_t prime) { primes.push_back(static_cast<Prime>(prime)); };
+            });
+
+            std::vector<Prime> primes;
+            std::size_t total = 0;
+            for (const auto &chunk : chunks) {
+                total += chunk.size();
+            }
+            primes.reserve(total);
+            for (const auto &chunk : chunks) {
+                primes.insert(primes.end(), chunk.begin(), chunk.end());
+            }
+            return primes;
+        }
+    }
+
+    namespace {
+        // Calls visit(index, prime) for every prime up to sqrt(high) dividing low + index, primes in ascending order
+        template <typename Visit>
+        void for_each_small_divisor(const uint64_t low, const uint64_t high, Visit &&visit) {
+            if (high <= 4) {
+                return;
+            }
+
+            const auto primes = primes_below(static_cast<uint32_t>(isqrt(high - 1) + 1));
+            const uint64_t start = std::max<uint64_t>(low, 2);
+            for (const uint64_t prime : primes) {
+                for (uint64_t multiple = (start + prime - 1) / prime * prime; multiple < high; multiple += prime) {
+                    visit(multiple - low, prime);
+                }
+            }
+        }
+    }
+
+    std::vector<uint64_t> smallest_prime_factors(const uint64_t low, const uint64_t high) {
+        std::vector<uint64_t> factors(high > low ? high - low : 0, 0);
+        for_each_small_divisor(low, high, [&factors](const uint64_t index, const uint64_t prime) {
+            if (factors[index] == 0) {
+                factors[index] = prime;
+            }
+        });
+
+        // no prime up to the square root divides it, so it is a prime itself
+        for (uint64_t number = std::max<uint64_t>(low, 2); number < high; number++) {
+            if (factors[number - low] == 0) {
+                factors[number - low] = number;
+            }
+        }
+        return factors;
+    }
+
+    std::vector<std::vector<uint64_t>> factor_range(const uint64_t low, const uint64_t high) {
+        std::vector<std::vector<uint64_t>> factors(high > low ? high - low : 0);
+        std::vector<uint64_t> residues(factors.size());
+        for (std::size_t ii = 0; ii < residues.size(); ii++) {
+            residues[ii] = low + ii;
+        }
+
+        for_each_small_divisor(low, high, [&](const uint64_t index, const uint64_t prime) {
+            uint64_t &residue = residues[index];
+            do {
+                residue /= prime;
+                factors[index].push_back(prime);
+            } while (residue % prime == 0);
+        });
+
+        // what is left after dividing out every prime up to the square root is one or a prime
+        for (uint64_t number = std::max<uint64_t>(low, 2); number < high; number++) {
+            if (residues[number - low] > 1) {
+                factors[number - low].push_back(residues[number - low]);
+            }
+        }
+        return factors;
+    }
+
+    uint64_t isqrt(const uint64_t value) {
+        auto root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+        root = std::min<uint64_t>(root, UINT32_MAX);
+        while (root * root > value) {
+            root--;
+        }
+        while (root < UINT32_MAX && (root + 1) * (root + 1) <= value) {
+            root++;
+        }
+        return root;
+    }
+
+    std::vector<uint64_t> primes_in_range(const uint64_t low, const uint64_t high, const std::size_t threads) {
+        return collect_primes<uint64_t>(low, high, threads);
+    }
+
+    std::vector<uint32_t> primes_below(const uint32_t limit, const std::size_t threads) {
+        return collect_primes<uint32_t>(0, limit, threads);
+    }
+
+    std::size_t count_primes(const uint64_t low, const uint64_t high, const std::size_t threads) {
+        // one cache line per counter so the threads do not share them
+        struct alignas(64) Counter {
+            std::size_t count = 0;
+        };
+        std::vector<Counter> counters(std::max<std::size_t>(threads, 1));
+        sieve_range(low, high, threads, [&counters](const std::size_t chunk) {
+            return [&counter = counters[chunk]](uint64_t) { counter.count++; };
+        });
+
+        std::size_t total = 0;
+        for (const auto &counter : counters) {
+            total += counter.count;
+        }
+        return total;
+    }
+} // end namespace sieve
@@ -0,0 +1,584 @@
+#include "Siqs.h"
+#include "Sieve.h"
+#include "WordArithmetic.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace factor
+{
+    namespace {
+        constexpr std::size_t BLOCK_SIZE = 32'768;
+        // primes below this are not sieved, the threshold is lowered by their expected contribution instead
+        constexpr uint32_t SMALL_PRIME_BOUND = 32;
+        // dependencies wanted on top of the factor base size before the linear algebra starts
+        constexpr std::size_t EXTRA_RELATIONS = 32;
+        constexpr uint32_t LARGE_PRIME_MULTIPLIER = 64;
+        // bits below the estimated size of g(x) that a sieve location may miss and still be worth trial dividing
+        constexpr double THRESHOLD_SLACK = 4.0;
+        constexpr uint64_t CANDIDATE_MASK = 0x8080'8080'8080'8080ULL;
+
+        struct Parameters {
+            std::size_t bits;
+            std::size_t factor_base_size;
+            std::size_t blocks; // the sieve interval is [-M, M) with M = blocks * BLOCK_SIZE
+        };
+
+        constexpr Parameters PARAMETERS[] = {
+            {100, 200, 1},
+            {120, 300, 1},
+            {140, 600, 1},
+            {160, 1'200, 1},
+            {180, 2'000, 1},
+            {200, 3'500, 1},
+            {220, 5'000, 2},
+            {240, 6'500, 2},
+            {260, 8'500, 3},
+            {280, 11'000, 3},
+            {300, 14'000, 4},
+            {330, 19'000, 4},
+        };
+
+        Parameters choose_parameters(const std::size_t bits) {
+            for (const auto &parameters : PARAMETERS) {
+                if (bits <= parameters.bits) {
+                    return parameters;
+                }
+            }
+            return {bits, 24'000, 6};
+        }
+
+        struct FactorBasePrime {
+            uint32_t prime;
+            uint32_t root; // sqrt(n) mod prime
+            uint8_t log; // rounded and scaled log2(prime)
+        };
+
+        // (A x + B)^2 = A g(x) (mod n), factors are factor base columns with multiplicity, column 0 is the sign
+        struct Relation {
+            BigUint root;
+            std::vector<uint32_t> columns;
+            uint64_t large_prime = 1; // shared by the two partial relations this one was combined from
+        };
+
+        // quotient and remainder by a divisor below 2^32
+        std::pair<BigUint, uint32_t> divide_by_word(const BigUint &number, const uint32_t divisor) {
+            constexpr int digitBits = std::numeric_limits<BigUint::DigitType>::digits;
+            const auto &digits = number.get_digits();
+            BigUint::Digits quotient(digits.size());
+            uint64_t remainder = 0;
+            for (std::size_t ii = digits.size(); ii-- > 0;) {
+                const uint64_t current = (remainder << digitBits) | digits[ii];
+                quotient[ii] = static_cast<BigUint::DigitType>(current / divisor);
+                remainder = current % divisor;
+            }
+            BigUint result;
+            result.set_digits(quotient);
+            return {std::move(result), static_cast<uint32_t>(remainder)};
+        }
+
+        void add_signed(SignedBigUint &lhs, const BigUint &magnitude, const bool negative) {
+            if (lhs.negative == negative) {
+                lhs.magnitude += magnitude;
+            }
+            else if (lhs.magnitude >= magnitude) {
+                lhs.magnitude -= magnitude;
+            }
+            else {
+                lhs.magnitude = magnitude - lhs.magnitude;
+                lhs.negative = negative;
+            }
+            if (lhs.magnitude == BigUint::ZERO) {
+                lhs.negative = false;
+            }
+        }
+
+        class Sieve {
+        public:
+            Sieve(const BigUint &number, std::vector<FactorBasePrime> factorBase, const Parameters &parameters)
+                : n_(number), factorBase_(std::move(factorBase)), halfWidth_(parameters.blocks * BLOCK_SIZE) {
+                const uint64_t largest = factorBase_.back().prime;
+                largePrimeBound_ = largest * LARGE_PRIME_MULTIPLIER;
+
+                // |g(x)| is at most about M sqrt(n / 2), the unsieved small primes add two roots' worth of log p / (p - 1)
+                double skipped = 0.0;
+                for (const auto &entry : factorBase_) {
+                    if (entry.prime < SMALL_PRIME_BOUND) {
+                        skipped += (entry.prime == 2 ? 1.0 : 2.0) * std::log2(entry.prime) / (entry.prime - 1);
+                    }
+                }
+                const double bits = std::log2(static_cast<double>(halfWidth_)) + (static_cast<double>(n_.bit_length()) - 1.0) / 2.0;
+                const double threshold = std::max(1.0, bits - std::log2(static_cast<double>(largePrimeBound_)) - skipped - THRESHOLD_SLACK);
+
+                // logarithms are scaled so the threshold stays below 128, then every block starts at 128 - threshold
+                // and a candidate is any byte with its top bit set, which the scan tests eight bytes at a time
+                const double scale = std::min(1.0, 120.0 / threshold);
+                for (auto &entry : factorBase_) {
+                    entry.log = static_cast<uint8_t>(std::lround(std::log2(entry.prime) * scale));
+                }
+                initialLog_ = static_cast<uint8_t>(128 - std::lround(threshold * scale));
+
+                // A should be about sqrt(2 n) / M, built from s primes of around 11 bits each
+                targetBits_ = (static_cast<double>(n_.bit_length()) + 1.0) / 2.0 - std::log2(static_cast<double>(halfWidth_));
+                const double largestBits = std::log2(static_cast<double>(largest));
+                const double factorBits = std::min(11.0, largestBits - 1.0);
+                factorsOfA_ = std::max<std::size_t>(1, static_cast<std::size_t>(std::lround(targetBits_ / factorBits)));
+                // the window of A primes, [2^(bits - 1), 2^(bits + 1)), has to end inside the factor base
+                while (targetBits_ / static_cast<double>(factorsOfA_) + 1.0 > largestBits) {
+                    factorsOfA_++;
+                }
+                while (factorsOfA_ > 1 && targetBits_ / static_cast<double>(factorsOfA_) < std::log2(SMALL_PRIME_BOUND) + 1.0) {
+                    factorsOfA_--;
+                }
+            }
+
+            [[nodiscard]] std::size_t columns() const { return factorBase_.size() + 1; }
+
+            // Sieves every B of one random A and hands full relations and partial ones to the callbacks,
+            // false when the factor base has too few primes of the right size to form any A
+            template <typename Full, typename Partial>
+            bool sieve_one_a(std::mt19937_64 &rng, const std::atomic<bool> &stop, Full &&full, Partial &&partial) const {
+                const std::vector<std::size_t> aIndices = choose_a(rng);
+                if (aIndices.empty()) {
+                    return false;
+                }
+
+                BigUint a = BigUint::ONE;
+                for (const auto index : aIndices) {
+                    a *= BigUint(factorBase_[index].prime);
+                }
+
+                // B_l = (A / q_l) gamma_l with gamma_l = sqrt(n) (A / q_l)^-1 mod q_l, so that B^2 = n (mod A)
+                const std::size_t s = aIndices.size();
+                std::vector<BigUint> bTerms(s);
+                for (std::size_t ll = 0; ll < s; ll++) {
+                    const auto &q = factorBase_[aIndices[ll]];
+                    const BigUint cofactor = a / BigUint(q.prime);
+                    const uint64_t inverse = word::pow_mod(cofactor.remainder_by_word(q.prime), q.prime - 2, q.prime);
+                    uint64_t gamma = word::mul_mod(q.root, inverse, q.prime);
+                    if (gamma > q.prime / 2) {
+                        gamma = q.prime - gamma;
+                    }
+                    bTerms[ll] = cofactor * BigUint(static_cast<BigUint::WideDigitType>(gamma));
+                }
+
+                SignedBigUint b;
+                for (const auto &term : bTerms) {
+                    b.magnitude += term;
+                }
+
+                // roots of g modulo every factor base prime as offsets into [0, 2M), and 2 B_l A^-1 mod p for the Gray code
+                const std::size_t size = factorBase_.size();
+                std::vector<uint32_t> root1(size, 0);
+                std::vector<uint32_t> root2(size, 0);
+                std::vector<std::vector<uint32_t>> steps(s, std::vector<uint32_t>(size, 0));
+                std::vector<uint8_t> dividesA(size, 0);
+                for (const auto index : aIndices) {
+                    dividesA[index] = 1;
+                }
+                for (std::size_t jj = 1; jj < size; jj++) {
+                    if (dividesA[jj]) {
+                        continue;
+                    }
+                    const uint32_t p = factorBase_[jj].prime;
+                    const uint64_t aInverse = word::pow_mod(a.remainder_by_word(p), p - 2, p);
+                    for (std::size_t ll = 0; ll < s; ll++) {
+                        steps[ll][jj] = static_cast<uint32_t>(word::mul_mod(2 * bTerms[ll].remainder_by_word(p), aInverse, p));
+                    }
+                    const uint64_t bModP = b.mod(BigUint::from_native_word(p)).as_native_word().value();
+                    const uint64_t offset = halfWidth_ % p;
+                    const uint64_t r = factorBase_[jj].root;
+                    root1[jj] = static_cast<uint32_t>((word::mul_mod((r + p - bModP) % p, aInverse, p) + offset) % p);
+                    root2[jj] = static_cast<uint32_t>((word::mul_mod((2 * p - r - bModP) % p, aInverse, p) + offset) % p);
+                }
+
+                std::vector<bool> signs(s, false);
+                const std::size_t polynomials = std::size_t{1} << (s - 1);
+                std::vector<uint8_t> block(BLOCK_SIZE);
+                std::vector<uint32_t> next1(size);
+                std::vector<uint32_t> next2(size);
+                for (std::size_t polynomial = 0; polynomial < polynomials; polynomial++) {
+                    if (stop.load(std::memory_order_relaxed)) {
+                        return true;
+                    }
+
+                    if (polynomial > 0) {
+                        // Gray code: flip the sign of B_l for l = 1 + trailing zeros, B changes by -+ 2 B_l
+                        const std::size_t ll = 1 + static_cast<std::size_t>(std::countr_zero(polynomial));
+                        signs[ll] = !signs[ll];
+                        const bool subtracting = signs[ll];
+                        add_signed(b, bTerms[ll].shift_left_bits(1), subtracting);
+                        for (std::size_t jj = 1; jj < size; jj++) {
+                            if (dividesA[jj]) {
+                                continue;
+                            }
+                            const uint32_t p = factorBase_[jj].prime;
+                            const uint32_t step = steps[ll][jj];
+                            // x = (+-t - B) / A moves by +2 B_l / A when B loses 2 B_l
+                            if (subtracting) {
+                                root1[jj] = root1[jj] + step >= p ? root1[jj] + step - p : root1[jj] + step;
+                                root2[jj] = root2[jj] + step >= p ? root2[jj] + step - p : root2[jj] + step;
+                            }
+                            else {
+                                root1[jj] = root1[jj] >= step ? root1[jj] - step : root1[jj] + p - step;
+                                root2[jj] = root2[jj] >= step ? root2[jj] - step : root2[jj] + p - step;
+                            }
+                        }
+                    }
+
+                    std::copy(root1.begin(), root1.end(), next1.begin());
+                    std::copy(root2.begin(), root2.end(), next2.begin());
+                    for (std::size_t start = 0; start < 2 * halfWidth_; start += BLOCK_SIZE) {
+                        std::ranges::fill(block, initialLog_);
+                        const std::size_t end = start + BLOCK_SIZE;
+                        for (std::size_t jj = 1; jj < size; jj++) {
+                            const auto &entry = factorBase_[jj];
+                            if (entry.prime < SMALL_PRIME_BOUND || dividesA[jj]) {
+                                continue;
+                            }
+                            uint32_t position = next1[jj];
+                            for (; position < end; position += entry.prime) {
+                                block[position - start] += entry.log;
+                            }
+                            next1[jj] = position;
+                            position = next2[jj];
+                            for (; position < end; position += entry.prime) {
+                                block[position - start] += entry.log;
+                            }
+                            next2[jj] = position;
+                        }
+
+                        for (std::size_t ii = 0; ii < BLOCK_SIZE; ii += sizeof(uint64_t)) {
+                            uint64_t bytes;
+                            std::memcpy(&bytes, block.data() + ii, sizeof(bytes));
+                            if ((bytes & CANDIDATE_MASK) == 0) {
+                                continue;
+                            }
+                            for (std::size_t jj = ii; jj < ii + sizeof(uint64_t); jj++) {
+                                if (block[jj] & 0x80) {
+                                    check_candidate(start + jj, a, b, aIndices, dividesA, root1, root2, full, partial);
+                                }
+                            }
+                        }
+                    }
+                }
+                return true;
+            }
+
+        private:
+            const BigUint &n_;
+            std::vector<FactorBasePrime> factorBase_;
+            std::size_t halfWidth_;
+            uint64_t largePrimeBound_;
+            uint8_t initialLog_;
+            double targetBits_;
+            std::size_t factorsOfA_;
+
+            // s distinct factor base indices whose primes multiply to about the target size of A
+            [[nodiscard]] std::vector<std::size_t> choose_a(std::mt19937_64 &rng) const {
+                const double bitsPerFactor = targetBits_ / static_cast<double>(factorsOfA_);
+                const auto lower = std::ranges::lower_bound(factorBase_, std::max(std::exp2(bitsPerFactor - 1.0), static_cast<double>(SMALL_PRIME_BOUND)),
+                    std::less{}, [](const FactorBasePrime &entry) { return static_cast<double>(entry.prime); });
+                const auto upper = std::ranges::lower_bound(factorBase_, std::exp2(bitsPerFactor + 1.0),
+                    std::less{}, [](const FactorBasePrime &entry) { return static_cast<double>(entry.prime); });
+                const auto first = static_cast<std::size_t>(lower - factorBase_.begin());
+                const auto last = static_cast<std::size_t>(upper - factorBase_.begin());
+                if (last <= first + factorsOfA_) {
+                    return {};
+                }
+
+                std::vector<std::size_t> indices;
+                std::uniform_int_distribution<std::size_t> pick(first, last - 1);
+                double bits = 0.0;
+                while (indices.size() + 1 < factorsOfA_) {
+                    const std::size_t index = pick(rng);
+                    if (std::ranges::find(indices, index) == indices.end()) {
+                        indices.push_back(index);
+                        bits += std::log2(factorBase_[index].prime);
+                    }
+                }
+
+                // the last prime brings the product closest to the target
+                const double wanted = std::exp2(targetBits_ - bits);
+                std::size_t best = first;
+                double bestDistance = std::numeric_limits<double>::max();
+                for (std::size_t index = first; index < factorBase_.size(); index++) {
+                    const double distance = std::abs(static_cast<double>(factorBase_[index].prime) - wanted);
+                    if (distance < bestDistance && std::ranges::find(indices, index) == indices.end()) {
+                        best = index;
+                        bestDistance = distance;
+                    }
+                    if (factorBase_[index].prime > wanted) {
+                        break;
+                    }
+                }
+                indices.push_back(best);
+                return indices;
+            }
+
+            template <typename Full, typename Partial>
+            void check_candidate(const std::size_t position, const BigUint &a, const SignedBigUint &b, const std::vector<std::size_t> &aIndices,
+                                 const std::vector<uint8_t> &dividesA, const std::vector<uint32_t> &root1, const std::vector<uint32_t> &root2,
+                                 Full &&full, Partial &&partial) const {
+                // u = A x + B with x = position - M, then A g(x) = u^2 - n
+                const bool negativeX = position < halfWidth_;
+                const uint64_t magnitudeX = negativeX ? halfWidth_ - position : position - halfWidth_;
+                SignedBigUint u = b;
+                add_signed(u, a * BigUint::from_native_word(magnitudeX), negativeX);
+                const BigUint square = u.magnitude.square();
+                const bool negative = square < n_;
+                BigUint value = (negative ? n_ - square : square - n_) / a;
+                if (value == BigUint::ZERO) {
+                    return;
+                }
+
+                Relation relation;
+                relation.root = u.magnitude % n_;
+                if (negative) {
+                    relation.columns.push_back(0);
+                }
+                for (const auto index : aIndices) {
+                    relation.columns.push_back(static_cast<uint32_t>(index + 1));
+                }
+
+                for (std::size_t jj = 0; jj < factorBase_.size(); jj++) {
+                    const uint32_t p = factorBase_[jj].prime;
+                    if (jj > 0 && !dividesA[jj]) {
+                        const auto residue = static_cast<uint32_t>(position % p);
+                        if (residue != root1[jj] && residue != root2[jj]) {
+                            continue;
+                        }
+                    }
+                    while (true) {
+                        auto [quotient, remainder] = divide_by_word(value, p);
+                        if (remainder != 0) {
+                            break;
+                        }
+                        value = std::move(quotient);
+                        relation.columns.push_back(static_cast<uint32_t>(jj + 1));
+                    }
+                }
+
+                if (value == BigUint::ONE) {
+                    full(std::move(relation));
+                    return;
+                }
+                if (const auto cofactor = value.as_native_word(); cofactor && *cofactor < largePrimeBound_) {
+                    relation.large_prime = *cofactor;
+                    partial(std::move(relation));
+                }
+            }
+        };
+
+        // Rows are relations, each with its exponent vector mod 2 followed by an identity part that records which
+        // relations were added together. Rows whose exponent part is cleared are dependencies
+        std::vector<std::vector<std::size_t>> find_dependencies(const std::vector<Relation> &relations, const std::size_t columns) {
+            const std::size_t rows = relations.size();
+            const std::size_t exponentWords = (columns + 63) / 64;
+            const std::size_t words = exponentWords + (rows + 63) / 64;
+            std::vector<std::vector<uint64_t>> matrix(rows, std::vector<uint64_t>(words, 0));
+            for (std::size_t row = 0; row < rows; row++) {
+                for (const auto column : relations[row].columns) {
+                    matrix[row][column / 64] ^= uint64_t{1} << (column % 64);
+                }
+                matrix[row][exponentWords + row / 64] |= uint64_t{1} << (row % 64);
+            }
+
+            std::vector<bool> pivot(rows, false);
+            for (std::size_t column = 0; column < columns; column++) {
+                const std::size_t word = column / 64;
+                const uint64_t bit = uint64_t{1} << (column % 64);
+                std::size_t chosen = rows;
+                for (std::size_t row = 0; row < rows; row++) {
+                    if (!pivot[row] && (matrix[row][word] & bit)) {
+                        chosen = row;
+                        break;
+                    }
+                }
+                if (chosen == rows) {
+                    continue;
+                }
+                pivot[chosen] = true;
+                for (std::size_t row = 0; row < rows; row++) {
+                    if (!pivot[row] && (matrix[row][word] & bit)) {
+                        for (std::size_t ww = word; ww < words; ww++) {
+                            matrix[row][ww] ^= matrix[chosen][ww];
+                        }
+                    }
+                }
+            }
+
+            std::vector<std::vector<std::size_t>> dependencies;
+            for (std::size_t row = 0; row < rows; row++) {
+                if (pivot[row]) {
+                    continue;
+                }
+                std::vector<std::size_t> dependency;
+                for (std::size_t other = 0; other < rows; other++) {
+                    if (matrix[row][exponentWords + other / 64] & (uint64_t{1} << (other % 64))) {
+                        dependency.push_back(other);
+                    }
+                }
+                dependencies.push_back(std::move(dependency));
+            }
+            return dependencies;
+        }
+
+        // gcd(X - Y, n) with X the product of the roots and Y the square root of the product of the values
+        std::optional<BigUint> try_dependency(const BigUint &number, const std::vector<FactorBasePrime> &factorBase,
+                                              const std::vector<Relation> &relations, const std::vector<std::size_t> &dependency) {
+            std::vector<uint32_t> exponents(factorBase.size() + 1, 0);
+            BigUint x = BigUint::ONE;
+            BigUint y = BigUint::ONE;
+            for (const auto index : dependency) {
+                const auto &relation = relations[index];
+                x = BigUint::mod_mul(x, relation.root, number);
+                if (relation.large_prime != 1) {
+                    y = BigUint::mod_mul(y, BigUint::from_native_word(relation.large_prime), number);
+                }
+                for (const auto column : relation.columns) {
+                    exponents[column]++;
+                }
+            }
+
+            for (std::size_t column = 1; column < exponents.size(); column++) {
+                if (exponents[column] % 2 != 0) {
+                    return std::nullopt;
+                }
+                for (uint32_t ii = 0; ii < exponents[column] / 2; ii++) {
+                    y = BigUint::mod_mul(y, BigUint(factorBase[column - 1].prime), number);
+                }
+            }
+
+            const BigUint difference = x >= y ? x - y : y - x;
+            BigUint divisor = BigUint::gcd(difference, number);
+            if (divisor == BigUint::ONE || divisor == number) {
+                return std::nullopt;
+            }
+            return divisor;
+        }
+    }
+
+    std::optional<BigUint> siqs(const BigUint &number, std::size_t threads) {
+        if (number < BigUint(4)) {
+            return std::nullopt;
+        }
+        if (number.is_even()) {
+            return BigUint::TWO;
+        }
+        if (const auto word = number.as_native_word()) {
+            if (word::is_prime(*word)) {
+                return std::nullopt;
+            }
+            return BigUint::from_native_word(word::pollard_rho(*word));
+        }
+
+        // 2 plus the odd primes modulo which n is a square, a prime dividing n ends the search right away
+        const Parameters parameters = choose_parameters(number.bit_length());
+        std::vector<FactorBasePrime> factorBase{{2, 1, 0}};
+        for (uint32_t limit = 1'024; factorBase.size() < parameters.factor_base_size; limit *= 2) {
+            factorBase.resize(1);
+            for (const auto prime : sieve::primes_below(limit)) {
+                if (prime == 2) {
+                    continue;
+                }
+                const auto residue = static_cast<uint32_t>(number.remainder_by_word(prime));
+                if (residue == 0) {
+                    return BigUint(prime);
+                }
+                if (word::jacobi(residue, prime) == 1) {
+                    factorBase.push_back({prime, static_cast<uint32_t>(word::sqrt_mod(residue, prime).value()), 0});
+                    if (factorBase.size() == parameters.factor_base_size) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        const Sieve quadraticSieve(number, factorBase, parameters);
+        threads = std::max<std::size_t>(threads, 1);
+        std::vector<Relation> relations;
+        std::unordered_map<uint64_t, Relation> partials;
+        std::mutex mutex;
+        std::size_t wanted = quadraticSieve.columns() + EXTRA_RELATIONS;
+        uint64_t seed = 0;
+
+        // a handful of rounds, each one adds relations until there are more than columns and tries every dependency
+        std::atomic<bool> noA = false;
+        for (int round = 0; round < 8 && !noA; round++) {
+            std::atomic<bool> stop = relations.size() >= wanted;
+            const auto worker = [&](const uint64_t workerSeed) {
+                std::mt19937_64 rng(workerSeed);
+                std::vector<Relation> found;
+                std::vector<Relation> foundPartials;
+                const auto full = [&found](Relation relation) { found.push_back(std::move(relation)); };
+                const auto partial = [&foundPartials](Relation relation) { foundPartials.push_back(std::move(relation)); };
+                while (!stop.load()) {
+                    if (!quadraticSieve.sieve_one_a(rng, stop, full, partial)) {
+                        noA = true;
+                        stop = true;
+                        return;
+                    }
+
+                    const std::lock_guard lock(mutex);
+                    for (auto &relation : found) {
+                        relations.push_back(std::move(relation));
+                    }
+                    // two partial relations with the same large prime multiply into a full one with that prime squared
+                    for (auto &relation : foundPartials) {
+                        const auto itr = partials.find(relation.large_prime);
+                        if (itr == partials.end()) {
+                            partials.emplace(relation.large_prime, std::move(relation));
+                            continue;
+                        }
+                        if (itr->second.root == relation.root) {
+                            continue;
+                        }
+                        Relation combined;
+                        combined.root = BigUint::mod_mul(itr->second.root, relation.root, number);
+                        combined.columns = itr->second.columns;
+                        combined.columns.insert(combined.columns.end(), relation.columns.begin(), relation.columns.end());
+                        combined.large_prime = relation.large_prime;
+                        relations.push_back(std::move(combined));
+                    }
+                    found.clear();
+                    foundPartials.clear();
+                    if (relations.size() >= wanted) {
+                        stop = true;
+                    }
+                }
+            };
+
+            if (threads == 1) {
+                worker(seed++);
+            }
+            else {
+                std::vector<std::thread> workers;
+                workers.reserve(threads);
+                for (std::size_t ii = 0; ii < threads; ii++) {
+                    workers.emplace_back(worker, seed++);
+                }
+                for (auto &thread : workers) {
+                    thread.join();
+                }
+            }
+
+            for (const auto &dependency : find_dependencies(relations, quadraticSieve.columns())) {
+                if (auto divisor = try_dependency(number, factorBase, relations, dependency)) {
+                    return divisor;
+                }
+            }
+            wanted = relations.size() + EXTRA_RELATIONS;
+        }
+        return std::nullopt;
+    }
+} // end namespace factor
@@ -0,0 +1,166 @@
+#include "SweepCheckpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // Writes the file next to path and renames it over path once its contents are on the disk
+    void replace_file(const std::filesystem::path &path, const std::string &contents) {
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+#ifdef _WIN32
+        std::FILE *file = _wfopen(temporary.c_str(), L"wb");
+#else
+        std::FILE *file = std::fopen(temporary.c_str(), "wb");
+#endif
+        if (file == nullptr) {
+            throw std::runtime_error("Could not open file " + temporary.string());
+        }
+        bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+        written = written && _commit(_fileno(file)) == 0;
+#else
+        written = written && fsync(fileno(file)) == 0;
+#endif
+        if (std::fclose(file) != 0 || !written) {
+            throw std::runtime_error("Could not write file " + temporary.string());
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    std::filesystem::path fold_marker_path(const std::filesystem::path &journal_path) {
+        return std::filesystem::path(journal_path).replace_extension(".fold");
+    }
+}
+
+std::optional<SweepCheckpoint> SweepCheckpoint::load(const std::filesystem::path &path) {
+    std::ifstream fin(path);
+    if (!fin) {
+        return std::nullopt;
+    }
+
+    SweepCheckpoint checkpoint;
+    std::string key;
+    int version = 0;
+    bool hasNext = false;
+    while (fin >> key) {
+        if (key == "version") {
+            fin >> version;
+        }
+        else if (key == "next") {
+            fin >> checkpoint.next;
+            hasNext = true;
+        }
+        else if (key == "remaining") {
+            fin >> checkpoint.remaining;
+        }
+        else if (key == "window") {
+            fin >> checkpoint.window;
+        }
+        else if (key == "ecm") {
+            Ecm ecm;
+            fin >> ecm.number >> ecm.b1 >> ecm.curves;
+            checkpoint.ecm = std::move(ecm);
+        }
+        else {
+            throw std::runtime_error("unknown key " + key + " in checkpoint " + path.string());
+        }
+        if (!fin) {
+            throw std::runtime_error("Could not parse the value of " + key + " in checkpoint " + path.string());
+        }
+    }
+
+    if (version != VERSION || !hasNext) {
+        throw std::runtime_error(path.string() + " is not a version " + std::to_string(VERSION) + " sweep checkpoint");
+    }
+    return checkpoint;
+}
+
+void SweepCheckpoint::save(const std::filesystem::path &path) const {
+    std::ostringstream out;
+    out << "version " << VERSION << '\n'
+        << "next " << next << '\n'
+        << "remaining " << remaining << '\n'
+        << "window " << window << '\n';
+    if (ecm) {
+        out << "ecm " << ecm->number << ' ' << ecm->b1 << ' ' << ecm->curves << '\n';
+    }
+    replace_file(path, out.str());
+}
+
+void SweepCheckpoint::fold_committed(const std::filesystem::path &journal_path, const std::filesystem::path &table_path) const {
+    fold_journal(journal_path, table_path, [this](const BigUint &number, const std::vector<BigUint> &) { return number < next; });
+}
+
+factor::EcmProgress SweepCheckpoint::ecm_progress(FactorJournal &journal, const std::filesystem::path &path) {
+    factor::EcmProgress progress;
+    progress.done = [this](const BigUint &number, const uint64_t b1) -> std::size_t {
+        return ecm && ecm->number == number && ecm->b1 == b1 ? ecm->curves : 0;
+    };
+    progress.record = [this, &journal, path](const BigUint &number, const uint64_t b1, const std::size_t curves) {
+        ecm = Ecm{number, b1, curves};
+        journal.flush();
+        save(path);
+    };
+    return progress;
+}
+
+void undo_interrupted_fold(const std::filesystem::path &journal_path, const std::filesystem::path &table_path) {
+    const auto marker_path = fold_marker_path(journal_path);
+    if (!std::filesystem::exists(journal_path)) {
+        // the fold finished all but removing its marker
+        std::filesystem::remove(marker_path);
+        return;
+    }
+    std::uintmax_t size = 0;
+    if (std::ifstream marker(marker_path); marker >> size && std::filesystem::exists(table_path)) {
+        std::filesystem::resize_file(table_path, size);
+    }
+}
+
+void fold_journal(const std::filesystem::path &journal_path, const std::filesystem::path &table_path,
+                  const std::function<bool(const BigUint &, const std::vector<BigUint> &)> &keep) {
+    undo_interrupted_fold(journal_path, table_path);
+    const auto marker_path = fold_marker_path(journal_path);
+    if (!std::filesystem::exists(journal_path)) {
+        return;
+    }
+    if (!std::filesystem::exists(marker_path)) {
+        replace_file(marker_path, std::to_string(std::filesystem::exists(table_path) ? std::filesystem::file_size(table_path) : 0) + '\n');
+    }
+
+    // lines of the text table are separated by a leading line break
+    std::ofstream out;
+    (void) FactorJournal::replay(journal_path, [&](const BigUint &number, const std::vector<BigUint> &factors) {
+        if (!keep(number, factors)) {
+            return;
+        }
+        if (!out.is_open()) {
+            out.open(table_path, std::ios::app);
+            if (!out) {
+                throw std::runtime_error("Could not open file " + table_path.string());
+            }
+        }
+        out << '\n' << number;
+        for (const auto &factor : factors) {
+            out << ' ' << factor;
+        }
+    });
+
+    if (out.is_open()) {
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Could not write file " + table_path.string());
+        }
+    }
+    std::filesystem::remove(journal_path);
+    std::filesystem::remove(marker_path);
+}
@@ -0,0 +1,281 @@
+#include "WordArithmetic.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <bit>
+#include <stdexcept>
+
+namespace word
+{
+    uint64_t mul_mod(const uint64_t lhs, const uint64_t rhs, const uint64_t mod) {
+        if (mod == 0) {
+            throw std::runtime_error("modulus value cannot be zero");
+        }
+
+        uint64_t low;
+        const uint64_t high = multiply_wide(lhs, rhs, low);
+#if defined(_MSC_VER) && !defined(__clang__)
+        uint64_t remainder;
+        (void) _udiv128(high % mod, low, mod, &remainder);
+        return remainder;
+#else
+        return static_cast<uint64_t>(((static_cast<unsigned __int128>(high) << 64) | low) % mod);
+#endif
+    }
+
+    uint64_t pow_mod(uint64_t base, uint64_t exponent, const uint64_t mod) {
+        if (mod == 0) {
+            throw std::runtime_error("modulus value cannot be zero");
+        }
+
+        if (mod % 2 == 1 && mod > 1) {
+            const Montgomery montgomery(mod);
+            return montgomery.from_montgomery(montgomery.pow(montgomery.to_montgomery(base), exponent));
+        }
+
+        uint64_t result = 1 % mod;
+        base %= mod;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result = mul_mod(result, base, mod);
+            }
+            base = mul_mod(base, base, mod);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    Montgomery::Montgomery(const uint64_t mod)
+        : mod_(mod) {
+        if (mod % 2 == 0 || mod == 1) {
+            throw std::runtime_error("Montgomery modulus must be odd and greater than one");
+        }
+
+        // Newton iteration, every step doubles the number of correct low bits
+        inverse_ = mod;
+        for (int ii = 0; ii < 5; ii++) {
+            inverse_ *= 2 - mod * inverse_;
+        }
+
+        one_ = (0 - mod) % mod;
+        rSquared_ = mul_mod(one_, one_, mod);
+    }
+
+    uint64_t Montgomery::pow(uint64_t base, uint64_t exponent) const {
+        uint64_t result = one_;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result = multiply(result, base);
+            }
+            base = multiply(base, base);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    namespace {
+        constexpr std::array<uint64_t, 15> SMALL_PRIMES{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+
+        // Strong probable prime test to a base already in Montgomery form, number - 1 = odd 2^shift
+        bool strong_probable_prime(const Montgomery &montgomery, const uint64_t base, const uint64_t odd, const int shift) {
+            const uint64_t one = montgomery.one();
+            const uint64_t minusOne = montgomery.subtract(0, one);
+            uint64_t x = montgomery.pow(base, odd);
+            if (x == one || x == minusOne) {
+                return true;
+            }
+
+            for (int ii = 1; ii < shift; ii++) {
+                x = montgomery.multiply(x, x);
+                if (x == minusOne) {
+                    return true;
+                }
+                if (x == one) {
+                    return false;
+                }
+            }
+            return false;
+        }
+    }
+
+    bool is_prime(const uint64_t number) {
+        if (number < 2) {
+            return false;
+        }
+
+        for (const auto prime : SMALL_PRIMES) {
+            if (number % prime == 0) {
+                return number == prime;
+            }
+        }
+
+        if (number < SMALL_PRIMES.back() * SMALL_PRIMES.back()) {
+            return true;
+        }
+
+        // Sinclair's bases are a deterministic set for every n < 2^64
+        constexpr std::array<uint64_t, 7> bases{2, 325, 9'375, 28'178, 450'775, 9'780'504, 1'795'265'022};
+        const Montgomery montgomery(number);
+        const int shift = std::countr_zero(number - 1);
+        const uint64_t odd = (number - 1) >> shift;
+        for (const auto base : bases) {
+            const uint64_t reduced = base % number;
+            if (reduced == 0) {
+                continue;
+            }
+            if (!strong_probable_prime(montgomery, montgomery.to_montgomery(reduced), odd, shift)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int jacobi(uint64_t a, uint64_t n) {
+        if (n % 2 == 0) {
+            throw std::runtime_error("Jacobi symbol needs an odd modulus");
+        }
+
+        a %= n;
+        int result = 1;
+        while (a != 0) {
+            const int zeros = std::countr_zero(a);
+            a >>= zeros;
+            // (2 / n) = -1 exactly when n = 3, 5 (mod 8)
+            if (zeros % 2 == 1 && (n % 8 == 3 || n % 8 == 5)) {
+                result = -result;
+            }
+            // quadratic reciprocity for odd a and n
+            if (a % 4 == 3 && n % 4 == 3) {
+                result = -result;
+            }
+            const uint64_t remainder = n % a;
+            n = a;
+            a = remainder;
+        }
+        return n == 1 ? result : 0;
+    }
+
+    std::optional<uint64_t> sqrt_mod(uint64_t a, const uint64_t p) {
+        a %= p;
+        if (a == 0) {
+            return 0;
+        }
+        if (p % 4 == 3) {
+            const uint64_t root = pow_mod(a, (p + 1) / 4, p);
+            return mul_mod(root, root, p) == a ? std::optional(root) : std::nullopt;
+        }
+
+        // p - 1 = odd 2^shift, z generates the 2-Sylow subgroup
+        const int shift = std::countr_zero(p - 1);
+        const uint64_t odd = (p - 1) >> shift;
+        uint64_t z = 2;
+        while (jacobi(z, p) != -1) {
+            z++;
+        }
+
+        int order = shift;
+        uint64_t c = pow_mod(z, odd, p);
+        uint64_t t = pow_mod(a, odd, p);
+        uint64_t root = pow_mod(a, (odd + 1) / 2, p);
+        while (t != 1) {
+            // least i with t^(2^i) = 1
+            int ii = 0;
+            for (uint64_t power = t; power != 1; power = mul_mod(power, power, p)) {
+                ii++;
+            }
+            if (ii == order) {
+                return std::nullopt;
+            }
+
+            uint64_t b = c;
+            for (int jj = 0; jj < order - ii - 1; jj++) {
+                b = mul_mod(b, b, p);
+            }
+            order = ii;
+            c = mul_mod(b, b, p);
+            t = mul_mod(t, c, p);
+            root = mul_mod(root, b, p);
+        }
+        return root;
+    }
+
+    uint64_t pollard_rho(const uint64_t number) {
+        if (number % 2 == 0 || number < 9 || is_prime(number)) {
+            throw std::runtime_error("Pollard rho needs an odd composite");
+        }
+
+        // gcds are taken on products of this many differences, one gcd per batch instead of per step
+        constexpr uint64_t batchSize = 128;
+        const Montgomery montgomery(number);
+        for (uint64_t increment = 1;; increment++) {
+            const uint64_t c = montgomery.to_montgomery(increment);
+            const auto step = [&](const uint64_t x) { return montgomery.add(montgomery.multiply(x, x), c); };
+
+            uint64_t y = montgomery.to_montgomery(2);
+            uint64_t x = y;
+            uint64_t saved = y;
+            uint64_t product = montgomery.one();
+            uint64_t divisor = 1;
+            for (uint64_t length = 1; divisor == 1; length *= 2) {
+                x = y;
+                for (uint64_t ii = 0; ii < length; ii++) {
+                    y = step(y);
+                }
+                for (uint64_t done = 0; done < length && divisor == 1; done += batchSize) {
+                    saved = y;
+                    for (uint64_t ii = 0; ii < std::min(batchSize, length - done); ii++) {
+                        y = step(y);
+                        product = montgomery.multiply(product, montgomery.subtract(x, y));
+                    }
+                    divisor = std::gcd(product, number);
+                }
+            }
+
+            // the batch overshot, replay it one step at a time
+            if (divisor == number) {
+                do {
+                    saved = step(saved);
+                    divisor = std::gcd(montgomery.subtract(x, saved), number);
+                } while (divisor == 1);
+            }
+
+            if (divisor != number) {
+                return divisor;
+            }
+        }
+    }
+
+    std::vector<uint64_t> factor(uint64_t number) {
+        std::vector<uint64_t> factors;
+        if (number < 2) {
+            return factors;
+        }
+
+        for (const auto prime : SMALL_PRIMES) {
+            while (number % prime == 0) {
+                factors.push_back(prime);
+                number /= prime;
+            }
+        }
+
+        std::vector<uint64_t> pending;
+        if (number > 1) {
+            pending.push_back(number);
+        }
+        while (!pending.empty()) {
+            const uint64_t value = pending.back();
+            pending.pop_back();
+            if (is_prime(value)) {
+                factors.push_back(value);
+                continue;
+            }
+
+            const uint64_t divisor = pollard_rho(value);
+            pending.push_back(divisor);
+            pending.push_back(value / divisor);
+        }
+
+        std::ranges::sort(factors);
+        return factors;
+    }
+} // end namespace word
@@ -0,0 +1,41 @@
+#include "BatchGcd.h"
+#include <gtest/gtest.h>
+#include <fstream>
+
+TEST(BatchGcdTest, product_tree) {
+    const std::vector<BigUint> moduli{BigUint(3), BigUint(5), BigUint(7), BigUint(11), BigUint(13)};
+    const auto tree = batch_gcd::build_product_tree(moduli);
+    ASSERT_EQ(tree.size(), 4);
+    EXPECT_EQ(tree[1], (std::vector<BigUint>{BigUint(15), BigUint(77), BigUint(13)}));
+    EXPECT_EQ(tree[2], (std::vector<BigUint>{BigUint(1155), BigUint(13)}));
+    EXPECT_EQ(tree[3], std::vector<BigUint>{BigUint(15015)});
+}
+
+TEST(BatchGcdTest, shared_factors) {
+    const BigUint p = BigUint::TWO.pow_by(89).minus_one();
+    const BigUint q = BigUint::TWO.pow_by(107).minus_one();
+    const BigUint r = BigUint::TWO.pow_by(127).minus_one();
+    const BigUint s = BigUint::TWO.pow_by(61).minus_one();
+    const std::vector<BigUint> moduli{p * q, BigUint(1009) * BigUint(1013), q * r, BigUint(65537) * s, p * r, BigUint(65537) * BigUint(3)};
+
+    const auto factors = batch_gcd::shared_factors(moduli);
+    const std::vector<BigUint> expected{p * q, BigUint::ONE, q * r, BigUint(65537), p * r, BigUint(65537)};
+    EXPECT_EQ(factors, expected);
+
+    EXPECT_TRUE(batch_gcd::shared_factors({}).empty());
+    EXPECT_EQ(batch_gcd::shared_factors(std::vector<BigUint>{p}), std::vector<BigUint>{BigUint::ONE});
+    EXPECT_THROW(batch_gcd::shared_factors(std::vector<BigUint>{p, BigUint::ZERO}), std::runtime_error);
+}
+
+TEST(BatchGcdTest, read_moduli_from_file) {
+    const auto path = std::filesystem::temp_directory_path() / "batch-gcd-test.txt";
+    {
+        std::ofstream out(path);
+        out << "15 3 5\n\n77 7 11\n123456789012345678901234567890\n";
+    }
+
+    const auto moduli = batch_gcd::read_moduli_from_file(path);
+    std::filesystem::remove(path);
+    EXPECT_EQ(moduli, (std::vector<BigUint>{BigUint(15), BigUint(77), BigUint::from_base10_string("123456789012345678901234567890")}));
+    EXPECT_THROW(batch_gcd::read_moduli_from_file(path), std::runtime_error);
+}
@@ -18,6 +18,14 @@ public:
     static [[nodiscard]] BigUint multiplyFFT(const BigUint &lhs, const BigUint& rhs) {
         return lhs.multiply_me_fft(rhs);
     }
+
+    static [[nodiscard]] BigUint subquadraticGcd(const BigUint &lhs, const BigUint& rhs) {
+        return BigUint::subquadratic_gcd(lhs, rhs);
+    }
+
+    static [[nodiscard]] BigUint lehmerGcd(const BigUint &lhs, const BigUint& rhs) {
+        return BigUint::lehmer_gcd(lhs, rhs);
+    }
 };
 
 TEST(BigUintTest, default_constructor_creates_biguint_zero) {
@@ -227,7 +235,7 @@ TEST(BigUintTest, subtract_big_number) {
 
     const BigUint c("65535|65535|65535");
     obtained_result = c - b;
-    expected_result = BigUint("65534|65535|0");
+    expected_result = BigUint("65535|0|0");
     EXPECT_EQ(obtained_result, expected_result);
 
     EXPECT_THROW(obtained_result = b - c;, std::runtime_error);
@@ -417,6 +425,16 @@ TEST(BigUintTest, divide_by_ten) {
     EXPECT_EQ(remainder, BigUint::ZERO);
 }
 
+TEST(BigUintTest, remainder_by_word) {
+    const BigUint dividend = BigUint::from_base10_string("123456789012345678901234567890");
+    EXPECT_EQ(BigUint::ZERO.remainder_by_word(7), 0U);
+    EXPECT_EQ(dividend.remainder_by_word(1), 0U);
+    EXPECT_EQ(dividend.remainder_by_word(10), 0U);
+    EXPECT_EQ(dividend.remainder_by_word(4'294'967'291), (dividend % BigUint::from_native_word(4'294'967'291)).as_native_word());
+    const uint64_t largest = BigUint::WORD_DIVISOR_BOUND - 1;
+    EXPECT_EQ(dividend.remainder_by_word(largest), (dividend % BigUint::from_native_word(largest)).as_native_word());
+}
+
 TEST(BigUintTest, to_base_10_string) {
     EXPECT_EQ(BigUint::ZERO.to_base10_string(), "0");
     EXPECT_EQ(BigUint::ONE.to_base10_string(), "1");
@@ -494,7 +512,7 @@ TEST(BigUintTest, gcd) {
     a = BigUint::from_base10_string("12345678901234567890");
     b = BigUint::from_base10_string("11223344556677889900");
     g = BigUint::gcd(a, b);
-    EXPECT_EQ(g.as_digit(), 30);
+    EXPECT_EQ(g.as_digit(), 90);
 
     a = BigUint::from_base10_string("4294967296");
     b = BigUint::from_base10_string("1853020188851841");
@@ -502,6 +520,35 @@ TEST(BigUintTest, gcd) {
     EXPECT_EQ(g, BigUint::ONE);
 }
 
+TEST(BigUintTest, gcd_of_big_numbers) {
+    // 4 * (2^127 - 1) is the greatest common divisor
+    BigUint a = BigUint::from_base10_string("45191878410997242810015374749012172509230051949217055256209558792746041280587655946251480303133391877018200998552889168155698897833816");
+    BigUint b = BigUint::from_base10_string("119209289550781249999999999999999999999299350767837591464538135208355041934359869029061742114121465858056976011675134860805729466159813934147372");
+    EXPECT_EQ(BigUint::gcd(a, b), BigUint::from_base10_string("680564733841876926926749214863536422908"));
+    EXPECT_EQ(BigUint::gcd(b, a), BigUint::from_base10_string("680564733841876926926749214863536422908"));
+
+    // 2^280 * 3^20 is the greatest common divisor
+    a = BigUint::from_base10_string("1462384028266435813656771377498398799466264870452673513331725979239209932064091174127102558501271523819064733466624");
+    b = BigUint::from_base10_string("43126625832716028225884000798154250733629529155735931734448159196730883521969894105316818110787651296296534566552441441354776576");
+    EXPECT_EQ(BigUint::gcd(a, b), BigUint::from_base10_string("6773667589720622295334202504025961183609319451502717708376427503255831944485576075392713752576"));
+
+    EXPECT_EQ(BigUint::gcd(a, BigUint::ZERO), a);
+    EXPECT_EQ(BigUint::gcd(BigUint::ZERO, b), b);
+    EXPECT_EQ(BigUint::gcd(a, a), a);
+}
+
+TEST(BigUintTest, bit_shifts) {
+    const BigUint value = BigUint::from_base10_string("1606938044258990275541962092341162602522202993782792835313721"); // 2^200 + 12345
+    EXPECT_EQ(value.bit_length(), 201);
+    EXPECT_EQ(value.shift_right_bits(37), BigUint::from_base10_string("11692013098647223345629478661730264157247460343808"));
+    EXPECT_EQ(value.shift_left_bits(45), BigUint::from_base10_string("56539106072908298546665520023773392506479484700019806660325749514800463872"));
+    EXPECT_EQ(value.shift_left_bits(45).shift_right_bits(45), value);
+    EXPECT_EQ(value.shift_right_bits(201), BigUint::ZERO);
+    EXPECT_EQ(BigUint::ZERO.bit_length(), 0);
+    EXPECT_EQ(BigUint(4096).count_trailing_zeros(), 12);
+    EXPECT_EQ(BigUint::TWO.pow_by(100).count_trailing_zeros(), 100);
+}
+
 TEST(BigUintTest, lcm) {
     BigUint a(4096);
     BigUint b(144);
@@ -511,7 +558,7 @@ TEST(BigUintTest, lcm) {
     a = BigUint::from_base10_string("12345678901234567890");
     b = BigUint::from_base10_string("11223344556677889900");
     l = BigUint::lcm(a, b);
-    EXPECT_EQ(l, BigUint::from_base10_string("4618660269822135341434463931449843700"));
+    EXPECT_EQ(l, BigUint::from_base10_string("1539553423274045113811487977149947900"));
 
     a = BigUint::from_base10_string("4294967296");
     b = BigUint::from_base10_string("1853020188851841");
@@ -530,7 +577,7 @@ TEST(BigUintTest, NaiveMultiplication) {
 TEST(BigUintTest, KaratsubaMultiplication) {
     const BigUint a = BigUint::from_base10_string("123456789");
     const BigUint b = BigUint::from_base10_string("987654321");
-    const BigUint result = BigUintTestAccessor::multiplyFFT(a, b);
+    const BigUint result = BigUintTestAccessor::multiplyKaratsuba(a, b);
     const BigUint expected = BigUint::from_base10_string("121932631112635269");
     EXPECT_EQ(result, expected);
 }
@@ -543,6 +590,239 @@ TEST(BigUintTest, FFTMultiplication) {
     EXPECT_EQ(result, expected);
 }
 
+TEST(BigUintTest, big_multiplications_agree) {
+    const BigUint a = BigUint(3).pow_by(20'000) + BigUint(12'345);
+    const BigUint b = BigUint(7).pow_by(9'000).minus_one();
+    const BigUint naive = BigUintTestAccessor::multiplyNaive(a, b);
+    EXPECT_EQ(BigUintTestAccessor::multiplyKaratsuba(a, b), naive);
+    EXPECT_EQ(BigUintTestAccessor::multiplyFFT(a, b), naive);
+    EXPECT_EQ(a * b, naive);
+    EXPECT_EQ(a.square(), BigUintTestAccessor::multiplyNaive(a, a));
+}
+
+TEST(BigUintTest, big_division) {
+    const BigUint a = BigUint(3).pow_by(5'000) + BigUint(12'345);
+    const BigUint b = BigUint(7).pow_by(1'500).minus_one();
+    const BigUint r = BigUint(5).pow_by(1'000);
+    const auto [quotient, remainder] = (a * b + r).divide_by(b);
+    EXPECT_EQ(quotient, a);
+    EXPECT_EQ(remainder, r);
+
+    // Divisor with the top digit set, no normalization shift
+    const BigUint c = BigUint::TWO.pow_by(4'096).minus_one();
+    EXPECT_EQ((a * c + r) / c, a);
+    EXPECT_EQ((a * c + r) % c, r);
+}
+
+TEST(BigUintTest, newton_division) {
+    const BigUint divisor = BigUint(3).pow_by(50'000).plus_one();
+    const BigUint dividend = BigUint::TWO.pow_by(BigUint(300'000)).minus_one();
+    const auto [quotient, remainder] = dividend.divide_by(divisor);
+    EXPECT_LT(remainder, divisor);
+    EXPECT_EQ(quotient * divisor + remainder, dividend);
+    EXPECT_EQ((divisor * divisor.square()).divide_by(divisor), std::make_pair(divisor.square(), BigUint::ZERO));
+}
+
+TEST(BigUintTest, subquadratic_gcd) {
+    const BigUint factor = BigUint::TWO.pow_by(521).minus_one() * BigUint(3).pow_by(700);
+    const BigUint a = factor * (BigUint(5).pow_by(30'000) + BigUint::ONE);
+    const BigUint b = factor * (BigUint(11).pow_by(19'000).minus_one());
+    const BigUint g = BigUintTestAccessor::subquadraticGcd(a, b);
+    EXPECT_EQ(g, BigUintTestAccessor::lehmerGcd(a, b));
+    EXPECT_EQ(g % factor, BigUint::ZERO);
+    EXPECT_EQ(a % g, BigUint::ZERO);
+    EXPECT_EQ(b % g, BigUint::ZERO);
+    EXPECT_EQ(BigUintTestAccessor::subquadraticGcd(a, a), a);
+    EXPECT_EQ(BigUintTestAccessor::subquadraticGcd(a, factor), factor);
+}
+
+TEST(BigUintTest, extended_gcd) {
+    const BigUint a = BigUint::from_base10_string("1227083404817416524103495823102787380521234561");
+    const BigUint b = BigUint::from_base10_string("98765432109876543210987654321");
+    const auto [gcd, x, y] = BigUint::extended_gcd(a, b);
+    EXPECT_EQ(gcd, BigUint::gcd(a, b));
+    EXPECT_NE(x.negative, y.negative);
+    const BigUint positive = x.negative ? b * y.magnitude : a * x.magnitude;
+    const BigUint negative = x.negative ? a * x.magnitude : b * y.magnitude;
+    EXPECT_EQ(positive - negative, gcd);
+
+    const auto zero = BigUint::extended_gcd(a, BigUint::ZERO);
+    EXPECT_EQ(zero.gcd, a);
+    EXPECT_EQ(zero.x, (SignedBigUint{BigUint::ONE, false}));
+    EXPECT_EQ(zero.y, (SignedBigUint{BigUint::ZERO, false}));
+}
+
+TEST(BigUintTest, mod_inverse) {
+    EXPECT_EQ(BigUint::mod_inverse(BigUint(3), BigUint(11)), BigUint(4));
+    EXPECT_EQ(BigUint::mod_inverse(BigUint(14), BigUint(11)), BigUint(4));
+    EXPECT_EQ(BigUint::mod_inverse(BigUint(7), BigUint(40)), BigUint(23));
+    EXPECT_EQ(BigUint::mod_inverse(BigUint(6), BigUint(9)), std::nullopt);
+    EXPECT_EQ(BigUint::mod_inverse(BigUint(22), BigUint(11)), std::nullopt);
+
+    const BigUint prime = BigUint::TWO.pow_by(127).minus_one();
+    const BigUint value = BigUint::from_base10_string("123456789012345678901234567890");
+    const auto inverse = BigUint::mod_inverse(value, prime);
+    ASSERT_TRUE(inverse.has_value());
+    EXPECT_EQ(*inverse * value % prime, BigUint::ONE);
+
+    const BigUint bigOdd = BigUint::TWO.pow_by(2203).minus_one();
+    const BigUint bigEven = BigUint::TWO.pow_by(2000);
+    const BigUint oddValue = value.plus_one();
+    for (const BigUint &mod : {bigOdd, bigEven}) {
+        const auto bigInverse = BigUint::mod_inverse(oddValue, mod);
+        ASSERT_TRUE(bigInverse.has_value());
+        EXPECT_EQ(*bigInverse * oddValue % mod, BigUint::ONE);
+    }
+    EXPECT_EQ(BigUint::mod_inverse(value, bigEven), std::nullopt);
+
+    EXPECT_THROW(BigUint::mod_inverse(value, BigUint::ZERO), std::runtime_error);
+    EXPECT_THROW(BigUint::mod_inverse(value, BigUint::ONE), std::runtime_error);
+}
+
+TEST(BigUintTest, batch_mod_inverse) {
+    const BigUint prime = BigUint::TWO.pow_by(521).minus_one();
+    std::vector<BigUint> values;
+    for (int ii = 1; ii <= 50; ii++) {
+        values.push_back(BigUint(3).pow_by(ii * 7) + BigUint(static_cast<BigUint::WideDigit>(ii)));
+    }
+
+    const auto inverses = BigUint::batch_mod_inverse(values, prime);
+    ASSERT_TRUE(inverses.has_value());
+    ASSERT_EQ(inverses->size(), values.size());
+    for (std::size_t ii = 0; ii < values.size(); ii++) {
+        EXPECT_EQ((*inverses)[ii], BigUint::mod_inverse(values[ii], prime));
+    }
+    EXPECT_EQ(BigUint::batch_mod_inverse(values, prime, 4), inverses);
+    EXPECT_EQ(BigUint::batch_mod_inverse(values, prime, 100), inverses);
+
+    values.push_back(prime * BigUint(5));
+    EXPECT_EQ(BigUint::batch_mod_inverse(values, prime), std::nullopt);
+    EXPECT_EQ(BigUint::batch_mod_inverse(values, prime, 3), std::nullopt);
+    EXPECT_EQ(BigUint::batch_mod_inverse({}, prime), std::vector<BigUint>{});
+}
+
+TEST(BigUintTest, native_word) {
+    EXPECT_EQ(BigUint::from_native_word(0), BigUint::ZERO);
+    EXPECT_EQ(BigUint::from_native_word(18'446'744'073'709'551'615ULL), BigUint::TWO.pow_by(64).minus_one());
+    EXPECT_EQ(BigUint::TWO.pow_by(64).minus_one().as_native_word(), 18'446'744'073'709'551'615ULL);
+    EXPECT_EQ(BigUint::TWO.pow_by(64).as_native_word(), std::nullopt);
+
+    const BigUint max = BigUint::TWO.pow_by(64).minus_one();
+    EXPECT_EQ(max * max, BigUint::TWO.pow_by(128) - BigUint::TWO.pow_by(65) + BigUint::ONE);
+    EXPECT_EQ(max.square(), max * max);
+    EXPECT_EQ(max / BigUint(1'000'000'007), BigUint::from_native_word(18'446'743'944ULL));
+    EXPECT_EQ(max % BigUint(1'000'000'007), BigUint(582'344'007));
+    EXPECT_EQ(BigUint::mod_mul(max, max.minus_one(), BigUint::from_native_word(18'446'744'073'709'551'557ULL)), BigUint(3'306));
+}
+
+TEST(BigUintTest, isqrt_and_iroot) {
+    EXPECT_EQ(BigUint::ZERO.isqrt(), BigUint::ZERO);
+    EXPECT_EQ(BigUint::ONE.isqrt(), BigUint::ONE);
+    EXPECT_EQ(BigUint(99).isqrt(), BigUint(9));
+    EXPECT_EQ(BigUint(100).isqrt(), BigUint(10));
+    EXPECT_EQ(BigUint::TWO.pow_by(64).minus_one().isqrt(), BigUint(4'294'967'295));
+    EXPECT_EQ(BigUint(80).iroot(3), BigUint(4));
+    EXPECT_EQ(BigUint(81).iroot(4), BigUint(3));
+    EXPECT_EQ(BigUint(1'000).iroot(1), BigUint(1'000));
+    EXPECT_EQ(BigUint(1'000).iroot(100), BigUint::ONE);
+    EXPECT_THROW((void) BigUint(8).iroot(0), std::runtime_error);
+
+    // exact powers and their neighbours, from a few words up to far beyond double range
+    const std::vector<std::pair<BigUint, uint32_t>> cases{{BigUint(3), 2}, {BigUint(12'345), 3}, {BigUint::TWO.pow_by(40).plus_one(), 2},
+                                                          {BigUint(7).pow_by(300), 2}, {BigUint(10).pow_by(50).plus_one(), 7},
+                                                          {BigUint(3).pow_by(2'000).minus_one(), 2}, {BigUint(5).pow_by(700), 13}, {BigUint(6), 1'001}};
+    for (const auto &[base, k] : cases) {
+        const BigUint power = base.pow_by(BigUint(k));
+        EXPECT_EQ(power.iroot(k), base) << k;
+        EXPECT_EQ(power.minus_one().iroot(k), base.minus_one()) << k;
+        EXPECT_EQ(power.plus_one().iroot(k), base) << k;
+    }
+    const BigUint big = BigUint(3).pow_by(10'000) + BigUint(12'345);
+    const BigUint root = big.isqrt();
+    EXPECT_LE(root.square(), big);
+    EXPECT_GT(root.plus_one().square(), big);
+
+    // a small root of a large number, where a start below the root made the iteration crawl
+    const BigUint wide = BigUint(7).pow_by(BigUint(1'009)) * BigUint(11);
+    const BigUint small = wide.iroot(1'013);
+    EXPECT_LE(small.pow_by(BigUint(1'013)), wide);
+    EXPECT_GT(small.plus_one().pow_by(BigUint(1'013)), wide);
+}
+
+TEST(BigUintTest, is_perfect_power) {
+    for (const uint32_t number : {0u, 1u, 2u, 6u, 12u, 26u, 28u, 1'000'001u, 4'294'967'295u}) {
+        EXPECT_FALSE(BigUint(number).is_perfect_power()) << number;
+    }
+    EXPECT_EQ(BigUint(4).is_perfect_power(), std::pair(BigUint(2), uint32_t{2}));
+    EXPECT_EQ(BigUint(1'024).is_perfect_power(), std::pair(BigUint(2), uint32_t{10}));
+    EXPECT_EQ(BigUint(216).is_perfect_power(), std::pair(BigUint(6), uint32_t{3}));
+    EXPECT_EQ(BigUint(3).pow_by(BigUint(36)).is_perfect_power(), std::pair(BigUint(3), uint32_t{36}));
+
+    // the exponent is the largest one, also for a base with a power of two in it
+    const BigUint base = BigUint(10).pow_by(20).plus_one();
+    for (const uint32_t exponent : {2u, 3u, 6u, 7u, 35u}) {
+        const BigUint power = base.pow_by(BigUint(exponent));
+        EXPECT_EQ(power.is_perfect_power(), std::pair(base, exponent)) << exponent;
+        EXPECT_FALSE(power.plus_one().is_perfect_power()) << exponent;
+        EXPECT_FALSE(power.minus_one().is_perfect_power()) << exponent;
+        EXPECT_EQ(BigUint(12).pow_by(BigUint(exponent)).is_perfect_power(), std::pair(BigUint(12), exponent)) << exponent;
+    }
+    EXPECT_EQ(BigUint::TWO.pow_by(BigUint(1'009)).is_perfect_power(), std::pair(BigUint::TWO, uint32_t{1'009}));
+    EXPECT_FALSE((BigUint(7).pow_by(BigUint(1'009)) * BigUint(11)).is_perfect_power());
+}
+
+TEST(BigUintTest, jacobi) {
+    EXPECT_THROW((void) BigUint::jacobi(BigUint(3), BigUint(10)), std::runtime_error);
+    EXPECT_EQ(BigUint::jacobi(BigUint(1'001), BigUint(9'907)), -1);
+    EXPECT_EQ(BigUint::jacobi(BigUint(19), BigUint(45)), 1);
+    EXPECT_EQ(BigUint::jacobi(BigUint(8), BigUint(21)), -1);
+    EXPECT_EQ(BigUint::jacobi(BigUint(5), BigUint::ONE), 1);
+
+    // multiplicative in the modulus: large composites against the symbols of their word sized prime factors
+    const BigUint p = BigUint::from_native_word(2'305'843'009'213'693'951);   // 2^61 - 1
+    const BigUint q = BigUint::from_native_word(18'446'744'073'709'551'557u); // 2^64 - 59
+    const BigUint n = p * q;
+    BigUint a = BigUint(3).pow_by(200);
+    for (int ii = 0; ii < 50; ii++) {
+        EXPECT_EQ(BigUint::jacobi(a, n), BigUint::jacobi(a % p, p) * BigUint::jacobi(a % q, q)) << a;
+        EXPECT_EQ(BigUint::jacobi(a, n * n), BigUint::jacobi(a, n) * BigUint::jacobi(a, n)) << a;
+        a = a * BigUint(7) + BigUint(ii);
+    }
+    EXPECT_EQ(BigUint::jacobi(p * BigUint(12'345), n), 0);
+    EXPECT_EQ(BigUint::jacobi(n.square(), n.plus_one().plus_one()), 1);
+}
+
+TEST(BigUintTest, mod_sqrt) {
+    EXPECT_THROW((void) BigUint::mod_sqrt(BigUint(4), BigUint(10)), std::runtime_error);
+    EXPECT_EQ(BigUint::mod_sqrt(BigUint(10), BigUint(13)).value().square() % BigUint(13), BigUint(10));
+    EXPECT_FALSE(BigUint::mod_sqrt(BigUint(5), BigUint(13)));
+
+    // one prime for every path: 3 (mod 4), 5 (mod 8) and 1 (mod 8) with 2^96 dividing p - 1
+    const std::vector<BigUint> primes{BigUint::TWO.pow_by(127).minus_one(), BigUint::TWO.pow_by(255) - BigUint(19),
+                                      BigUint::TWO.pow_by(224) - BigUint::TWO.pow_by(96) + BigUint::ONE};
+    for (const auto &p : primes) {
+        EXPECT_EQ(BigUint::mod_sqrt(BigUint::ZERO, p), BigUint::ZERO);
+        EXPECT_EQ(BigUint::mod_sqrt(p, p), BigUint::ZERO);
+        int residues = 0;
+        BigUint a = BigUint(10).pow_by(30);
+        for (int ii = 0; ii < 40; ii++) {
+            const auto root = BigUint::mod_sqrt(a, p);
+            EXPECT_EQ(root.has_value(), BigUint::jacobi(a, p) == 1) << a;
+            if (root) {
+                EXPECT_EQ(BigUint::mod_mul(*root, *root, p), a % p) << a;
+                residues++;
+            }
+            const BigUint square = BigUint::mod_mul(a, a, p);
+            const auto squareRoot = BigUint::mod_sqrt(square, p);
+            ASSERT_TRUE(squareRoot) << a;
+            EXPECT_TRUE(*squareRoot == a % p || *squareRoot == p - a % p) << a;
+            a = a * BigUint(3) + BigUint(ii);
+        }
+        EXPECT_GT(residues, 5);
+        EXPECT_LT(residues, 35);
+    }
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,415 @@
+#include "FactorCache.h"
+#include "FactorJournal.h"
+#include "FactorTable.h"
+#include "MappedFactorTable.h"
+#include "SweepCheckpoint.h"
+#include "WordArithmetic.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+    std::vector<BigUint> word_factors(const uint64_t number) {
+        const auto factors = word::factor(number);
+        if (factors.size() == 1) {
+            return {};
+        }
+        std::vector<BigUint> result;
+        for (const auto factor : factors) {
+            result.push_back(BigUint::from_native_word(factor));
+        }
+        return result;
+    }
+}
+
+TEST(FactorTableTest, hash) {
+    const std::hash<BigUint> hash;
+    EXPECT_EQ(hash(BigUint::from_base10_string("123456789012345678901234567890")), hash(BigUint::from_base10_string("123456789012345678901234567890")));
+    std::unordered_set<std::size_t> hashes;
+    for (uint32_t number = 0; number < 10'000; number++) {
+        hashes.insert(hash(BigUint(number)) & 0xFFFF);
+    }
+    // the low bits alone spread consecutive numbers
+    EXPECT_GT(hashes.size(), 8'000);
+}
+
+TEST(FactorTableTest, dense_range) {
+    FactorTable table;
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.find(BigUint(10)), std::nullopt);
+    EXPECT_EQ(table.largest(), std::nullopt);
+
+    table.add_range(2, 5'000);
+    table.add_range(5'000, 10'000);
+    EXPECT_THROW(table.add_range(20'000, 30'000), std::runtime_error);
+    EXPECT_EQ(table.size(), 9'998);
+    EXPECT_EQ(table.smallest(), BigUint(2));
+    EXPECT_EQ(table.largest(), BigUint(9'999));
+    for (uint64_t number = 2; number < 10'000; number++) {
+        EXPECT_EQ(table.find(BigUint::from_native_word(number)), word_factors(number)) << number;
+    }
+    EXPECT_EQ(table.find(BigUint(1)), std::nullopt);
+    EXPECT_EQ(table.find(BigUint(10'000)), std::nullopt);
+
+    // insertion continues the run
+    EXPECT_TRUE(table.insert(BigUint(10'000), {BigUint(2), BigUint(2), BigUint(2), BigUint(2), BigUint(5), BigUint(5), BigUint(5), BigUint(5)}));
+    EXPECT_FALSE(table.insert(BigUint(10'000), {}));
+    EXPECT_EQ(table.largest(), BigUint(10'000));
+    EXPECT_EQ(table.find(BigUint(10'000))->size(), 8);
+}
+
+TEST(FactorTableTest, window_above_two) {
+    constexpr uint64_t low = 1'000'000'000'000ULL;
+    FactorTable table;
+    table.add_range(low, low + 2'000);
+    for (uint64_t number = low; number < low + 2'000; number++) {
+        EXPECT_EQ(table.find(BigUint::from_native_word(number)), word_factors(number)) << number;
+    }
+}
+
+TEST(FactorTableTest, sparse_entries) {
+    FactorTable table;
+    const BigUint big = BigUint::TWO.pow_by(89).minus_one();
+    const BigUint composite = big * BigUint(3);
+    EXPECT_TRUE(table.insert(BigUint(2), {}));
+    EXPECT_TRUE(table.insert(BigUint(3), {}));
+    EXPECT_TRUE(table.insert(big, {}));
+    EXPECT_TRUE(table.insert(composite, {BigUint(3), big}));
+    EXPECT_TRUE(table.insert(BigUint(100), {BigUint(2), BigUint(2), BigUint(5), BigUint(5)}));
+    for (uint32_t number = 1'000; number < 1'500; number++) {
+        EXPECT_TRUE(table.insert(BigUint(number) * big, {}));
+    }
+    EXPECT_EQ(table.size(), 505);
+    EXPECT_EQ(table.find(big), std::vector<BigUint>{});
+    EXPECT_EQ(table.find(composite), (std::vector<BigUint>{BigUint(3), big}));
+    EXPECT_EQ(table.find(BigUint(100))->size(), 4);
+    EXPECT_EQ(table.find(big + BigUint(2)), std::nullopt);
+    EXPECT_TRUE(table.contains(BigUint(1'234) * big));
+    EXPECT_EQ(table.largest(), BigUint(1'499) * big);
+
+    std::vector<BigUint> numbers;
+    table.for_each([&numbers](const BigUint &number, const std::vector<BigUint> &) { numbers.push_back(number); });
+    EXPECT_EQ(numbers.size(), table.size());
+    EXPECT_TRUE(std::ranges::is_sorted(numbers));
+    EXPECT_EQ(numbers.front(), BigUint(2));
+}
+
+TEST(FactorTableTest, text_file) {
+    const auto path = std::filesystem::temp_directory_path() / "factor-table-test.txt";
+    {
+        std::ofstream out(path);
+        out << "2\n3\n4 2 2\n\n5\n6 2 3\n\n618970019642690137449562111\n1237940039285380274899124222 2 618970019642690137449562111";
+    }
+
+    const auto table = FactorTable::from_text_file(path);
+    EXPECT_EQ(table.size(), 7);
+    EXPECT_EQ(table.find(BigUint(6)), (std::vector<BigUint>{BigUint(2), BigUint(3)}));
+    EXPECT_EQ(table.find(BigUint::from_base10_string("618970019642690137449562111")), std::vector<BigUint>{});
+
+    table.write_text_file(path);
+    const auto reread = FactorTable::from_text_file(path);
+    std::filesystem::remove(path);
+    EXPECT_EQ(reread.size(), table.size());
+    EXPECT_EQ(reread.largest(), table.largest());
+    EXPECT_THROW((void) FactorTable::from_text_file(path), std::runtime_error);
+}
+
+TEST(FactorTableTest, parallel_text_file) {
+    const auto path = std::filesystem::temp_directory_path() / "factor-table-parallel-test.txt";
+    const BigUint big = BigUint::TWO.pow_by(127).minus_one();
+    {
+        std::ofstream out(path);
+        for (uint64_t number = 2; number < 200'000; number++) {
+            const auto factors = word_factors(number);
+            out << number;
+            for (const auto &factor : factors) {
+                out << ' ' << factor;
+            }
+            out << (number % 1'000 == 0 ? "\r\n\n" : "\n");
+        }
+        out << big << "\n" << big * big << '\t' << big << ' ' << big;
+    }
+
+    // several megabytes, so every thread gets its own chunk
+    const auto serial = FactorTable::from_text_file(path);
+    const auto parallel = FactorTable::from_text_file(path, 4);
+    EXPECT_EQ(parallel.size(), 200'000);
+    EXPECT_EQ(parallel.size(), serial.size());
+    for (uint64_t number = 2; number < 200'000; number += 997) {
+        EXPECT_EQ(parallel.find(BigUint::from_native_word(number)), word_factors(number)) << number;
+    }
+    EXPECT_EQ(parallel.find(big * big), (std::vector<BigUint>{big, big}));
+    EXPECT_EQ(parallel.largest(), big * big);
+
+    {
+        std::ofstream out(path, std::ios::app);
+        out << "\n12 2 2 x3";
+    }
+    try {
+        (void) FactorTable::from_text_file(path, 4);
+        ADD_FAILURE() << "a malformed line has to throw";
+    } catch (const std::runtime_error &e) {
+        EXPECT_NE(std::string(e.what()).find("line 200200"), std::string::npos) << e.what();
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(FactorTableTest, binary_file) {
+    const auto path = std::filesystem::temp_directory_path() / "factor-table-test.bin";
+    const BigUint big = BigUint::TWO.pow_by(89).minus_one();
+    FactorTable table;
+    table.add_range(2, 5'000);
+    EXPECT_TRUE(table.insert(big, {}));
+    EXPECT_TRUE(table.insert(BigUint(10'007), {}));
+    for (uint32_t number = 2; number < 300; number++) {
+        EXPECT_TRUE(table.insert(BigUint(number) * big, {BigUint(number), big}));
+    }
+    write_binary_factor_table(table, path);
+
+    {
+        const MappedFactorTable mapped(path);
+        EXPECT_EQ(mapped.size(), table.size());
+        for (uint64_t number = 0; number < 5'100; number++) {
+            EXPECT_EQ(mapped.find(BigUint::from_native_word(number)), table.find(BigUint::from_native_word(number))) << number;
+        }
+        EXPECT_EQ(mapped.find(big * BigUint(6)), (std::vector<BigUint>{BigUint(6), big}));
+        EXPECT_EQ(mapped.find(big), std::vector<BigUint>{});
+        EXPECT_TRUE(mapped.contains(BigUint(10'007)));
+        EXPECT_FALSE(mapped.contains(big + BigUint(2)));
+
+        std::vector<BigUint> numbers;
+        mapped.for_each([&numbers](const BigUint &number, const std::vector<BigUint> &) { numbers.push_back(number); });
+        EXPECT_EQ(numbers.size(), table.size());
+        EXPECT_TRUE(std::ranges::is_sorted(numbers));
+    }
+
+    // binary to text and back again
+    const auto text = std::filesystem::temp_directory_path() / "factor-table-test.txt";
+    convert_binary_to_text(path, text);
+    convert_text_to_binary(text, path);
+    {
+        const MappedFactorTable mapped(path);
+        EXPECT_EQ(mapped.size(), table.size());
+        EXPECT_EQ(mapped.find(BigUint(4'096))->size(), 12);
+    }
+
+    EXPECT_THROW(MappedFactorTable{text}, std::runtime_error);
+    std::filesystem::remove(text);
+    std::filesystem::remove(path);
+    EXPECT_THROW(MappedFactorTable{path}, std::runtime_error);
+}
+
+TEST(FactorTableTest, journal) {
+    const auto path = std::filesystem::temp_directory_path() / "factor-journal-test.journal";
+    std::filesystem::remove(path);
+    const BigUint big = BigUint::TWO.pow_by(89).minus_one();
+    {
+        JournalOptions options;
+        options.flush_records = 100;
+        options.buffer_bytes = 1'000;
+        FactorJournal journal(path, options);
+        std::vector<std::thread> threads;
+        for (uint32_t thread = 0; thread < 4; thread++) {
+            threads.emplace_back([&journal, &big, thread] {
+                for (uint32_t number = 1'000 * thread; number < 1'000 * (thread + 1); number++) {
+                    journal.append(big * BigUint(number + 2), {BigUint(number + 2), big});
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        journal.flush();
+        journal.append(big, {});
+    }
+
+    FactorTable table;
+    const auto visit = [&table](const BigUint &number, const std::vector<BigUint> &factors) { (void) table.insert(number, factors); };
+    EXPECT_EQ(FactorJournal::replay(path, visit), 4'001);
+    EXPECT_EQ(table.find(big * BigUint(2'345)), (std::vector<BigUint>{BigUint(2'345), big}));
+    EXPECT_EQ(table.find(big), std::vector<BigUint>{});
+
+    // a record torn by a crash is cut off, a damaged one ends the replay
+    const auto intact = std::filesystem::file_size(path);
+    {
+        // a header announcing 32 payload bytes followed by only two of them
+        constexpr char torn[] = {0x20, 0x00, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78, '1', '2'};
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write(torn, sizeof(torn));
+    }
+    EXPECT_EQ(FactorJournal::replay(path, visit), 4'001);
+    EXPECT_EQ(std::filesystem::file_size(path), intact);
+    {
+        std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(static_cast<std::streamoff>(intact) - 3);
+        out.put('0');
+    }
+    EXPECT_EQ(FactorJournal::replay(path, visit), 4'000);
+    EXPECT_LT(std::filesystem::file_size(path), intact);
+    std::filesystem::remove(path);
+    EXPECT_EQ(FactorJournal::replay(path, visit), 0);
+}
+
+TEST(FactorTableTest, sweep_checkpoint) {
+    const auto path = std::filesystem::temp_directory_path() / "sweep-test.checkpoint";
+    std::filesystem::remove(path);
+    EXPECT_EQ(SweepCheckpoint::load(path), std::nullopt);
+
+    SweepCheckpoint checkpoint;
+    checkpoint.next = BigUint::TWO.pow_by(80).plus_one();
+    checkpoint.remaining = 12'345;
+    checkpoint.save(path);
+    auto loaded = SweepCheckpoint::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->next, checkpoint.next);
+    EXPECT_EQ(loaded->remaining, 12'345);
+    EXPECT_EQ(loaded->window, 0);
+    EXPECT_FALSE(loaded->ecm.has_value());
+
+    checkpoint.window = 10'000;
+    checkpoint.ecm = SweepCheckpoint::Ecm{BigUint::TWO.pow_by(100).plus_one(), 11'000, 24};
+    checkpoint.save(path);
+    loaded = SweepCheckpoint::load(path);
+    ASSERT_TRUE(loaded && loaded->ecm);
+    EXPECT_EQ(loaded->window, 10'000);
+    EXPECT_EQ(loaded->ecm->number, checkpoint.ecm->number);
+    EXPECT_EQ(loaded->ecm->b1, 11'000);
+    EXPECT_EQ(loaded->ecm->curves, 24);
+
+    {
+        std::ofstream out(path);
+        out << "version 1\nremaining 3\n";
+    }
+    EXPECT_THROW((void) SweepCheckpoint::load(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(FactorTableTest, fold_journal) {
+    const auto table_path = std::filesystem::temp_directory_path() / "fold-test.txt";
+    const auto journal_path = std::filesystem::temp_directory_path() / "fold-test.journal";
+    const auto marker_path = std::filesystem::temp_directory_path() / "fold-test.fold";
+    std::filesystem::remove(journal_path);
+    {
+        std::ofstream(table_path) << "2\n3\n4 2 2";
+        FactorJournal journal(journal_path);
+        journal.append(BigUint(5), {});
+        journal.append(BigUint(6), {BigUint(2), BigUint(3)});
+    }
+    const auto size = std::filesystem::file_size(table_path);
+
+    // a fold cut short after its marker and part of a line
+    std::ofstream(marker_path) << size << '\n';
+    std::ofstream(table_path, std::ios::app) << "\n5\n6 2";
+    undo_interrupted_fold(journal_path, table_path);
+    EXPECT_EQ(std::filesystem::file_size(table_path), size);
+    EXPECT_TRUE(std::filesystem::exists(journal_path));
+
+    std::ofstream(table_path, std::ios::app) << "\n5\n6";
+    fold_journal(journal_path, table_path, [](const BigUint &, const std::vector<BigUint> &) { return true; });
+    EXPECT_FALSE(std::filesystem::exists(journal_path));
+    EXPECT_FALSE(std::filesystem::exists(marker_path));
+    const auto table = FactorTable::from_text_file(table_path);
+    EXPECT_EQ(table.size(), 5);
+    EXPECT_EQ(table.find(BigUint(6)), (std::vector<BigUint>{BigUint(2), BigUint(3)}));
+
+    // a marker left behind by a finished fold is dropped and the table kept
+    std::ofstream(marker_path) << 0 << '\n';
+    undo_interrupted_fold(journal_path, table_path);
+    EXPECT_FALSE(std::filesystem::exists(marker_path));
+    EXPECT_EQ(FactorTable::from_text_file(table_path).size(), 5);
+    std::filesystem::remove(table_path);
+}
+
+TEST(FactorTableTest, sweep_checkpoint_resume) {
+    const auto table_path = std::filesystem::temp_directory_path() / "resume-test.txt";
+    const auto journal_path = std::filesystem::temp_directory_path() / "resume-test.journal";
+    const auto checkpoint_path = std::filesystem::temp_directory_path() / "resume-test.checkpoint";
+    std::filesystem::remove(journal_path);
+    std::ofstream(table_path) << "2\n3\n4 2 2\n5";
+
+    SweepCheckpoint checkpoint;
+    checkpoint.next = BigUint(8);
+    checkpoint.remaining = 10;
+    const BigUint composite = BigUint::TWO.pow_by(100).plus_one();
+    checkpoint.ecm = SweepCheckpoint::Ecm{composite, 11'000, 24};
+    checkpoint.save(checkpoint_path);
+    {
+        // records from next on were journaled after the checkpoint was saved
+        FactorJournal journal(journal_path);
+        for (uint64_t number = 6; number < 10; number++) {
+            journal.append(BigUint::from_native_word(number), word_factors(number));
+        }
+    }
+
+    auto loaded = SweepCheckpoint::load(checkpoint_path);
+    ASSERT_TRUE(loaded.has_value());
+    loaded->fold_committed(journal_path, table_path);
+    EXPECT_FALSE(std::filesystem::exists(journal_path));
+    const auto table = FactorTable::from_text_file(table_path);
+    EXPECT_EQ(table.size(), 6);
+    EXPECT_EQ(table.find(BigUint(7)), std::vector<BigUint>{});
+    EXPECT_FALSE(table.contains(BigUint(8)));
+    EXPECT_FALSE(table.contains(BigUint(9)));
+
+    // the resumed ECM stage starts after the saved curves, and every round moves the checkpoint on
+    {
+        FactorJournal journal(journal_path);
+        const auto progress = loaded->ecm_progress(journal, checkpoint_path);
+        EXPECT_EQ(progress.done(composite, 11'000), 24);
+        EXPECT_EQ(progress.done(composite, 50'000), 0);
+        EXPECT_EQ(progress.done(composite.plus_one(), 11'000), 0);
+        progress.record(composite, 11'000, 32);
+    }
+    loaded = SweepCheckpoint::load(checkpoint_path);
+    ASSERT_TRUE(loaded && loaded->ecm);
+    EXPECT_EQ(loaded->ecm->curves, 32);
+    EXPECT_EQ(loaded->next, BigUint(8));
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(checkpoint_path) += ".tmp"));
+
+    std::filesystem::remove(journal_path);
+    std::filesystem::remove(checkpoint_path);
+    std::filesystem::remove(table_path);
+}
+
+TEST(FactorTableTest, cache) {
+    const BigUint big = BigUint::TWO.pow_by(89).minus_one();
+    FactorCache cache;
+    EXPECT_EQ(cache.find(big), std::nullopt);
+    EXPECT_TRUE(cache.insert(big, {}));
+    EXPECT_TRUE(cache.insert(big * BigUint(3), {BigUint(3), big}));
+    EXPECT_FALSE(cache.insert(big * BigUint(3), {}));
+    EXPECT_EQ(cache.find(big), std::vector<BigUint>{});
+    EXPECT_EQ(cache.find(big * BigUint(3)), (std::vector<BigUint>{BigUint(3), big}));
+    EXPECT_EQ(cache.size(), 2);
+
+    // threads publish overlapping ranges, every number ends up cached exactly once
+    FactorCache shared;
+    std::atomic<std::size_t> added = 0;
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&shared, &added, &big, thread] {
+            for (uint32_t number = 500 * thread; number < 500 * thread + 1'000; number++) {
+                added += shared.insert(big * BigUint(number + 2), {BigUint(number + 2), big});
+                EXPECT_TRUE(shared.find(big * BigUint(number + 2)).has_value());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(added, 2'500);
+    EXPECT_EQ(shared.size(), 2'500);
+
+    // a small budget keeps recently used entries and drops the others
+    FactorCache bounded(64 * 1'024, 4);
+    const BigUint hot = big * BigUint(7);
+    for (uint32_t number = 2; number < 5'000; number++) {
+        (void) bounded.insert(big * BigUint(number + 10), {BigUint(number + 10), big});
+        EXPECT_TRUE(number == 2 ? bounded.insert(hot, {BigUint(7), big}) : bounded.find(hot).has_value()) << number;
+    }
+    EXPECT_LE(bounded.bytes(), 64 * 1'024);
+    EXPECT_LT(bounded.size(), 4'000);
+    EXPECT_EQ(bounded.find(big * BigUint(12)), std::nullopt);
+    EXPECT_FALSE(bounded.insert(BigUint::TWO.pow_by(BigUint(300'000)), {}));
+}
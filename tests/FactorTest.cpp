@@ -0,0 +1,182 @@
+#include "Ecm.h"
+#include "Factorizer.h"
+#include "PollardRho.h"
+#include "Siqs.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+TEST(FactorTest, pollard_rho_brent) {
+    EXPECT_EQ(factor::pollard_rho_brent(BigUint(3)), std::nullopt);
+    EXPECT_EQ(factor::pollard_rho_brent(BigUint(1'000'000)), BigUint::TWO);
+    EXPECT_EQ(factor::pollard_rho_brent(BigUint::from_native_word(1'000'000'007ULL * 998'244'353ULL)), BigUint(998'244'353));
+
+    const BigUint number = BigUint::from_base10_string("100000000700000000039000000273");
+    for (const std::size_t threads : {1, 3}) {
+        const auto divisor = factor::pollard_rho_brent(number, threads);
+        ASSERT_TRUE(divisor.has_value());
+        EXPECT_TRUE(*divisor == BigUint(1'000'000'007) || *divisor == BigUint::from_base10_string("100000000000000000039"));
+    }
+
+    const BigUint larger = BigUint::from_base10_string("10141204821895892764384366166441");
+    const auto divisor = factor::pollard_rho_brent(larger);
+    ASSERT_TRUE(divisor.has_value());
+    EXPECT_EQ(larger % *divisor, BigUint::ZERO);
+    EXPECT_NE(*divisor, larger);
+
+    // 2^89 - 1 is prime, every polynomial gives up
+    const BigUint mersenne = BigUint::TWO.pow_by(89).minus_one();
+    EXPECT_EQ(factor::pollard_rho_brent(mersenne, 2, 10'000), std::nullopt);
+}
+
+TEST(FactorTest, ecm) {
+    EXPECT_EQ(factor::ecm(BigUint(1'000'000)), BigUint::TWO);
+
+    // 2^33 + 17 times 2^70 + 25
+    const BigUint number = BigUint::from_base10_string("10141204821895892764384366166441");
+    for (const std::size_t threads : {1, 3}) {
+        const auto divisor = factor::ecm(number, 2'000, 200'000, 50, threads);
+        ASSERT_TRUE(divisor.has_value());
+        EXPECT_TRUE(*divisor == BigUint::from_native_word(8'589'934'609ULL) || *divisor == BigUint::from_base10_string("1180591620717411303449"));
+    }
+
+    // a 40 bit factor of a 200 bit number
+    const BigUint prime = BigUint::from_native_word(1'099'511'627'791ULL);
+    const BigUint cofactor = BigUint::TWO.pow_by(160).add(BigUint(7));
+    const auto divisor = factor::ecm(prime * cofactor, 3'000, 300'000, 100);
+    ASSERT_TRUE(divisor.has_value());
+    EXPECT_EQ((prime * cofactor) % *divisor, BigUint::ZERO);
+
+    // 2^89 - 1 is prime, no curve finds anything
+    EXPECT_EQ(factor::ecm(BigUint::TWO.pow_by(89).minus_one(), 500, 5'000, 3), std::nullopt);
+    // every curve already ran
+    EXPECT_EQ(factor::ecm(number, 2'000, 200'000, 50, 1, 50), std::nullopt);
+}
+
+TEST(FactorTest, siqs) {
+    EXPECT_EQ(factor::siqs(BigUint(1'000'000)), BigUint::TWO);
+    // 3 is in the would be factor base
+    EXPECT_EQ(factor::siqs(BigUint::from_base10_string("3000000000000000000000000000000000000000009")), BigUint(3));
+
+    const BigUint p = BigUint::from_native_word(1'000'000'000'000'000'003ULL);
+    const BigUint q = BigUint::from_native_word(3'000'000'000'000'000'037ULL);
+    for (const std::size_t threads : {1, 2}) {
+        const auto divisor = factor::siqs(p * q, threads);
+        ASSERT_TRUE(divisor.has_value());
+        EXPECT_TRUE(*divisor == p || *divisor == q);
+    }
+
+    // 80 bits, the factor base ends below the size of the A primes a two prime A would need
+    for (const auto *text : {"786865578484526888615677", "907160225610783555195341"}) {
+        const BigUint number = BigUint::from_base10_string(text);
+        const auto divisor = factor::siqs(number);
+        ASSERT_TRUE(divisor.has_value()) << text;
+        EXPECT_EQ(number % *divisor, BigUint::ZERO) << text;
+        EXPECT_TRUE(*divisor != BigUint::ONE && *divisor != number) << text;
+    }
+
+    // 49 digits
+    const BigUint larger = BigUint::from_base10_string("7000000000000000000000110000000000000000000000427");
+    const auto divisor = factor::siqs(larger);
+    ASSERT_TRUE(divisor.has_value());
+    EXPECT_TRUE(*divisor == BigUint::from_base10_string("1000000000000000000000007") || *divisor == BigUint::from_base10_string("7000000000000000000000061"));
+}
+
+TEST(FactorTest, factorizer) {
+    const factor::Factorizer factorizer;
+    EXPECT_TRUE(factorizer.factor(BigUint::ZERO).empty());
+    EXPECT_TRUE(factorizer.factor(BigUint::ONE).empty());
+    EXPECT_EQ(factorizer.factor(BigUint(97)), std::vector<BigUint>{BigUint(97)});
+    EXPECT_EQ(factorizer.factor(BigUint(360)), (std::vector<BigUint>{BigUint(2), BigUint(2), BigUint(2), BigUint(3), BigUint(3), BigUint(5)}));
+    EXPECT_EQ(factorizer.factor(BigUint::TWO.pow_by(100)), std::vector<BigUint>(100, BigUint::TWO));
+
+    // small primes, a perfect power of a 30 bit prime and a prime cofactor
+    const BigUint prime(1'000'000'007);
+    const BigUint mersenne = BigUint::TWO.pow_by(89).minus_one();
+    std::vector<BigUint> expected{BigUint(3), BigUint(3), BigUint(65'537), prime, prime, prime, mersenne};
+    EXPECT_EQ(factorizer.factor(BigUint(9) * BigUint(65'537) * prime.pow_by(3) * mersenne), expected);
+
+    // two 20 digit primes need the quadratic sieve once rho and ECM have no budget
+    factor::FactorizerOptions options;
+    options.rho_iterations = 0;
+    options.ecm_curves = 0;
+    const BigUint p = BigUint::from_base10_string("100000000000000000039");
+    const BigUint q = BigUint::from_base10_string("300000000000000000053");
+    EXPECT_EQ(factor::Factorizer(options).factor(p * q), (std::vector<BigUint>{p, q}));
+
+    options.siqs_max_digits = 0;
+    EXPECT_THROW((void) factor::Factorizer(options).factor(p * q), std::runtime_error);
+
+    // a lookup answers before any stage runs
+    const factor::Factorizer table(options, [&](const BigUint &number) -> std::optional<std::vector<BigUint>> {
+        if (number == p * q) {
+            return std::vector{p, q};
+        }
+        return std::nullopt;
+    });
+    EXPECT_EQ(table.factor(p * q * BigUint(6)), (std::vector<BigUint>{BigUint(2), BigUint(3), p, q}));
+}
+
+TEST(FactorTest, factor_all) {
+    const factor::Factorizer factorizer;
+    std::vector<BigUint> numbers;
+    for (uint32_t number = 0; number < 200; number++) {
+        numbers.emplace_back(number);
+    }
+    numbers.push_back(BigUint::from_base10_string("100000000700000000039000000273"));
+    numbers.push_back(BigUint::TWO.pow_by(89).minus_one());
+
+    for (const std::size_t threads : {1, 4}) {
+        std::vector<std::size_t> order;
+        const auto results = factorizer.factor_all(numbers, threads, [&order](const std::size_t index, const std::optional<std::vector<BigUint>> &) {
+            order.push_back(index);
+        });
+        ASSERT_EQ(results.size(), numbers.size());
+        for (std::size_t ii = 0; ii < numbers.size(); ii++) {
+            EXPECT_EQ(results[ii], factorizer.factor(numbers[ii])) << numbers[ii];
+            EXPECT_EQ(order[ii], ii);
+        }
+    }
+    EXPECT_TRUE(factorizer.factor_all({}, 4).empty());
+
+    factor::FactorizerOptions options;
+    options.rho_iterations = 0;
+    options.ecm_curves = 0;
+    options.siqs_max_digits = 0;
+    const std::vector<BigUint> hard{BigUint(6), BigUint::from_base10_string("100000000700000000039000000273")};
+    std::vector<std::optional<std::vector<BigUint>>> emitted;
+    const auto record = [&emitted](const std::size_t, const std::optional<std::vector<BigUint>> &factors) { emitted.push_back(factors); };
+    EXPECT_THROW((void) factor::Factorizer(options).factor_all(hard, 2, record), std::runtime_error);
+    // the number that failed is emitted as such, not as a factorization
+    ASSERT_EQ(emitted.size(), 2u);
+    EXPECT_EQ(emitted[0], (std::vector<BigUint>{BigUint(2), BigUint(3)}));
+    EXPECT_FALSE(emitted[1]);
+}
+
+TEST(FactorTest, factorizer_ecm_progress) {
+    factor::FactorizerOptions options;
+    options.rho_iterations = 0;
+    options.siqs_max_digits = 0;
+    options.ecm_b1 = 2'000;
+    options.ecm_b2 = 200'000;
+    options.ecm_curves = 50;
+    const BigUint number = BigUint::from_base10_string("10141204821895892764384366166441");
+
+    std::vector<std::size_t> rounds;
+    factor::EcmProgress progress;
+    progress.record = [&rounds, &number](const BigUint &composite, const uint64_t b1, const std::size_t curves) {
+        EXPECT_EQ(composite, number);
+        EXPECT_EQ(b1, 2'000);
+        rounds.push_back(curves);
+    };
+    const factor::Factorizer factorizer(options, {}, progress);
+    EXPECT_EQ(factorizer.factor(number).size(), 2);
+    EXPECT_TRUE(std::ranges::is_sorted(rounds));
+    for (const auto curves : rounds) {
+        EXPECT_EQ(curves % 8, 0) << curves;
+    }
+
+    // an earlier run that finished every curve leaves nothing to try
+    progress.done = [](const BigUint &, uint64_t) -> std::size_t { return 50; };
+    const factor::Factorizer resumed(options, {}, progress);
+    EXPECT_THROW((void) resumed.factor(number), std::runtime_error);
+}
@@ -0,0 +1,135 @@
+#include "Montgomery.h"
+#include "Primality.h"
+#include "WordArithmetic.h"
+#include <gtest/gtest.h>
+
+TEST(WordArithmeticTest, modular_arithmetic) {
+    constexpr uint64_t mod = 18'446'744'073'709'551'557ULL; // largest prime below 2^64
+    EXPECT_EQ(word::mul_mod(mod - 1, mod - 1, mod), 1);
+    EXPECT_EQ(word::mul_mod(1ULL << 63, 4, 1'000'000'007), 164'688'009);
+    EXPECT_EQ(word::pow_mod(3, mod - 1, mod), 1);
+    EXPECT_EQ(word::pow_mod(2, 10, 1'000), 24);
+    EXPECT_EQ(word::pow_mod(5, 0, 1), 0);
+    EXPECT_THROW((void) word::mul_mod(2, 3, 0), std::runtime_error);
+
+    const word::Montgomery montgomery(mod);
+    const uint64_t a = montgomery.to_montgomery(mod - 2);
+    const uint64_t b = montgomery.to_montgomery(12'345);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.multiply(a, b)), mod - 24'690);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.add(a, b)), 12'343);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.subtract(b, a)), 12'347);
+    EXPECT_THROW(word::Montgomery(10), std::runtime_error);
+}
+
+TEST(WordArithmeticTest, jacobi) {
+    EXPECT_EQ(word::jacobi(1'001, 9'907), -1);
+    EXPECT_EQ(word::jacobi(19, 45), 1);
+    EXPECT_EQ(word::jacobi(8, 21), -1);
+    EXPECT_EQ(word::jacobi(5, 21), 1);
+    EXPECT_EQ(word::jacobi(6, 21), 0);
+    EXPECT_THROW((void) word::jacobi(3, 8), std::runtime_error);
+}
+
+TEST(WordArithmeticTest, sqrt_mod) {
+    EXPECT_EQ(word::sqrt_mod(0, 7), 0);
+    EXPECT_EQ(word::sqrt_mod(3, 7), std::nullopt);
+    EXPECT_EQ(word::sqrt_mod(5, 13), std::nullopt);
+    // 3 mod 4, 5 mod 8 and 1 mod 8 moduli
+    for (const uint64_t p : {1'000'000'007ULL, 998'244'353ULL, 13ULL, 17ULL, 18'446'744'073'709'551'557ULL}) {
+        for (const uint64_t a : {2ULL, 3ULL, 5ULL, 10ULL, 12'345ULL}) {
+            const auto root = word::sqrt_mod(a, p);
+            EXPECT_EQ(root.has_value(), word::jacobi(a, p) == 1) << a << " mod " << p;
+            if (root) {
+                EXPECT_EQ(word::mul_mod(*root, *root, p), a % p) << a << " mod " << p;
+            }
+        }
+    }
+}
+
+TEST(WordArithmeticTest, is_prime) {
+    const std::vector<uint64_t> primes{2, 3, 5, 97, 65'537, 1'000'000'007, 4'294'967'291ULL, 2'305'843'009'213'693'951ULL, 18'446'744'073'709'551'557ULL};
+    for (const auto prime : primes) {
+        EXPECT_TRUE(word::is_prime(prime)) << prime;
+    }
+
+    // Carmichael numbers and strong pseudoprimes to several prime bases
+    const std::vector<uint64_t> composites{0, 1, 4, 561, 2'047, 1'373'653, 25'326'001, 3'215'031'751ULL, 2'152'302'898'747ULL,
+                                           3'474'749'660'383ULL, 341'550'071'728'321ULL, 3'825'123'056'546'413'051ULL, 18'446'744'073'709'551'615ULL};
+    for (const auto composite : composites) {
+        EXPECT_FALSE(word::is_prime(composite)) << composite;
+    }
+
+    std::size_t count = 0;
+    for (uint64_t ii = 0; ii < 10'000; ii++) {
+        count += word::is_prime(ii);
+    }
+    EXPECT_EQ(count, 1'229);
+}
+
+TEST(MontgomeryTest, arithmetic) {
+    const BigUint mod = BigUint::TWO.pow_by(127).minus_one();
+    const Montgomery montgomery(mod);
+    const BigUint a = BigUint::from_base10_string("123456789012345678901234567890");
+    const BigUint b = BigUint::from_base10_string("98765432109876543210987654321");
+    const BigUint aMontgomery = montgomery.to_montgomery(a);
+    const BigUint bMontgomery = montgomery.to_montgomery(b);
+
+    EXPECT_EQ(montgomery.from_montgomery(aMontgomery), a);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.multiply(aMontgomery, bMontgomery)), a * b % mod);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.square(aMontgomery)), a.square() % mod);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.subtract(bMontgomery, aMontgomery)), mod - (a - b));
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.add(montgomery.half(aMontgomery), montgomery.half(aMontgomery))), a);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.pow(aMontgomery, mod.minus_one())), BigUint::ONE);
+    EXPECT_EQ(montgomery.from_montgomery(montgomery.pow(aMontgomery, BigUint(19))), a.pow_by(19) % mod);
+    EXPECT_EQ(montgomery.pow(aMontgomery, BigUint::ZERO), montgomery.one());
+    EXPECT_THROW(Montgomery(BigUint::TWO.pow_by(64)), std::runtime_error);
+}
+
+TEST(PrimalityTest, is_divisible_by) {
+    const BigUint number = BigUint::from_base10_string("123456789012345678901234567890");
+    EXPECT_TRUE(primality::is_divisible_by(number, uint8_t{9}));
+    EXPECT_FALSE(primality::is_divisible_by(number, uint8_t{11}));
+    EXPECT_TRUE(primality::is_divisible_by(number, BigUint(1234567890)));
+    EXPECT_FALSE(primality::is_divisible_by(number, BigUint(1234567891)));
+    EXPECT_THROW(primality::is_divisible_by(number, uint8_t{0}), std::runtime_error);
+}
+
+TEST(PrimalityTest, is_prime) {
+    // Mersenne exponents below 700
+    const std::vector<BigUint::DigitType> exponents{61, 89, 107, 127, 521, 607};
+    for (const auto exponent : exponents) {
+        EXPECT_TRUE(primality::is_prime(BigUint::TWO.pow_by(exponent).minus_one())) << exponent;
+    }
+    EXPECT_FALSE(primality::is_prime(BigUint::TWO.pow_by(67).minus_one()));
+    EXPECT_FALSE(primality::is_prime(BigUint::TWO.pow_by(101).minus_one()));
+    EXPECT_FALSE(primality::is_prime(BigUint::TWO.pow_by(523).minus_one()));
+
+    EXPECT_TRUE(primality::is_prime(BigUint::from_native_word(18'446'744'073'709'551'557ULL)));
+    EXPECT_TRUE(primality::is_prime(BigUint::TWO.pow_by(64) + BigUint(13)));
+
+    const BigUint p = BigUint::TWO.pow_by(89).minus_one();
+    const BigUint q = BigUint::TWO.pow_by(107).minus_one();
+    EXPECT_FALSE(primality::is_prime(p * q));
+    EXPECT_FALSE(primality::is_prime(p * p));
+    EXPECT_FALSE(primality::is_prime(p * BigUint(4'093)));
+
+    // Arnault's strong pseudoprime to every prime base below 307
+    const BigUint arnault = BigUint::from_base10_string(
+        "2887148238050771212671429597130393991977609459279722700926516024197432303799152733116328983144639225941977803110929349655578418949441740933805615113979999421542416933972905423711002751042080134966731755152859226962916775325475044445856101949404200039904432116776619949629539250452698719329070373564032273701278453899126120309244841494728976885406024976768122077071687938121709811322297802059565867");
+    EXPECT_FALSE(primality::is_prime(arnault));
+}
+
+TEST(WordArithmeticTest, factor) {
+    EXPECT_TRUE(word::factor(0).empty());
+    EXPECT_TRUE(word::factor(1).empty());
+    EXPECT_EQ(word::factor(2), std::vector<uint64_t>{2});
+    EXPECT_EQ(word::factor(360), (std::vector<uint64_t>{2, 2, 2, 3, 3, 5}));
+    EXPECT_EQ(word::factor(4'294'967'297ULL), (std::vector<uint64_t>{641, 6'700'417}));
+    EXPECT_EQ(word::factor(18'446'744'073'709'551'615ULL), (std::vector<uint64_t>{3, 5, 17, 257, 641, 65'537, 6'700'417}));
+    EXPECT_EQ(word::factor(4'294'967'291ULL * 4'294'967'279ULL), (std::vector<uint64_t>{4'294'967'279ULL, 4'294'967'291ULL}));
+    EXPECT_EQ(word::factor(4'294'967'291ULL * 4'294'967'291ULL), (std::vector<uint64_t>{4'294'967'291ULL, 4'294'967'291ULL}));
+    EXPECT_EQ(word::factor(18'446'744'073'709'551'557ULL), std::vector<uint64_t>{18'446'744'073'709'551'557ULL});
+    const uint64_t divisor = word::pollard_rho(10'403);
+    EXPECT_TRUE(divisor == 101 || divisor == 103) << divisor;
+    EXPECT_THROW((void) word::pollard_rho(97), std::runtime_error);
+}
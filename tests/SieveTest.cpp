@@ -0,0 +1,67 @@
+#include "Sieve.h"
+#include "WordArithmetic.h"
+#include <gtest/gtest.h>
+
+TEST(SieveTest, small_primes) {
+    EXPECT_TRUE(sieve::primes_below(0).empty());
+    EXPECT_TRUE(sieve::primes_below(2).empty());
+    EXPECT_EQ(sieve::primes_below(3), std::vector<uint32_t>{2});
+    EXPECT_EQ(sieve::primes_below(50), (std::vector<uint32_t>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47}));
+    EXPECT_EQ(sieve::primes_in_range(10, 38), (std::vector<uint64_t>{11, 13, 17, 19, 23, 29, 31, 37}));
+    EXPECT_EQ(sieve::primes_in_range(4, 5), std::vector<uint64_t>{});
+    EXPECT_EQ(sieve::primes_in_range(5, 6), std::vector<uint64_t>{5});
+}
+
+TEST(SieveTest, prime_counts) {
+    EXPECT_EQ(sieve::primes_below(1'000'000).size(), 78'498);
+    EXPECT_EQ(sieve::count_primes(0, 10'000'000), 664'579);
+    EXPECT_EQ(sieve::count_primes(0, 10'000'000, 4), 664'579);
+    EXPECT_EQ(sieve::primes_below(10'000'000, 3), sieve::primes_below(10'000'000));
+}
+
+TEST(SieveTest, high_range) {
+    constexpr uint64_t low = 1'000'000'000'000ULL;
+    constexpr uint64_t high = low + 100'000;
+    std::vector<uint64_t> expected;
+    for (uint64_t number = low; number < high; number++) {
+        if (word::is_prime(number)) {
+            expected.push_back(number);
+        }
+    }
+    EXPECT_EQ(sieve::primes_in_range(low, high), expected);
+    EXPECT_EQ(sieve::primes_in_range(low, high, 2), expected);
+}
+
+TEST(SieveTest, isqrt) {
+    EXPECT_EQ(sieve::isqrt(0), 0);
+    EXPECT_EQ(sieve::isqrt(15), 3);
+    EXPECT_EQ(sieve::isqrt(16), 4);
+    EXPECT_EQ(sieve::isqrt(18'446'744'073'709'551'615ULL), 4'294'967'295ULL);
+    EXPECT_EQ(sieve::isqrt(4'294'967'296ULL * 4'294'967'295ULL), 4'294'967'295ULL);
+}
+
+TEST(SieveTest, smallest_prime_factors) {
+    EXPECT_EQ(sieve::smallest_prime_factors(0, 12), (std::vector<uint64_t>{0, 0, 2, 3, 2, 5, 2, 7, 2, 3, 2, 11}));
+    EXPECT_TRUE(sieve::smallest_prime_factors(5, 5).empty());
+
+    constexpr uint64_t low = 1'000'000'000'000ULL;
+    const auto factors = sieve::smallest_prime_factors(low, low + 10'000);
+    for (uint64_t ii = 0; ii < factors.size(); ii++) {
+        EXPECT_EQ(factors[ii], word::factor(low + ii).front()) << low + ii;
+    }
+}
+
+TEST(SieveTest, factor_range) {
+    const auto small = sieve::factor_range(0, 13);
+    EXPECT_TRUE(small[0].empty());
+    EXPECT_TRUE(small[1].empty());
+    EXPECT_EQ(small[2], std::vector<uint64_t>{2});
+    EXPECT_EQ(small[4], (std::vector<uint64_t>{2, 2}));
+    EXPECT_EQ(small[12], (std::vector<uint64_t>{2, 2, 3}));
+
+    constexpr uint64_t low = 1'000'000'000'000ULL - 5'000;
+    const auto factors = sieve::factor_range(low, low + 10'000);
+    for (uint64_t ii = 0; ii < factors.size(); ii++) {
+        EXPECT_EQ(factors[ii], word::factor(low + ii)) << low + ii;
+    }
+}